@@ -1,42 +1,74 @@
 #pragma once
 
+#include "search_stats.h"
+
 #include <vector>
 #include <map>
+#include <memory>
 #include <mutex>
 using namespace std::string_literals;
 
 //Реализация структуры ПодМножества
-template <typename Key, typename Value>
+template <typename Key, typename Value, typename Allocator = std::allocator<std::pair<const Key, Value>>>
 struct SubMap {
-    std::map<Key, Value> sub_map;
+    explicit SubMap(const Allocator& allocator = Allocator()) : sub_map(allocator) {}
+    std::map<Key, Value, std::less<Key>, Allocator> sub_map;
     std::mutex sub_map_guard;
 };
 
-//Реализация класса ConcurrentMap
-template <typename Key, typename Value>
+//Реализация класса ConcurrentMap.
+//Узлы подмножеств и результат BuildOrdinaryMap размещаются через allocator
+//(например, polymorphic_allocator арены запроса)
+template <typename Key, typename Value, typename Allocator = std::allocator<std::pair<const Key, Value>>>
 class ConcurrentMap {
 public:
     static_assert(std::is_integral_v<Key>, "ConcurrentMap supports only integer keys");
 
+    using Map = std::map<Key, Value, std::less<Key>, Allocator>;
+
     struct Access {
-        Access(std::mutex& mutex, const Key& key, std::map<Key, Value>& sub_map_ref) : value_guard(mutex),
-                                                                                       ref_to_value(sub_map_ref[key]) {}
+        Access(std::mutex& mutex, const Key& key, Map& sub_map_ref) : value_guard(mutex, std::adopt_lock),
+                                                                      ref_to_value(sub_map_ref[key]) {}
         std::lock_guard<std::mutex> value_guard;
         Value& ref_to_value;
     };
-    ConcurrentMap(size_t bucket_count) : sub_maps(bucket_count) {};
+    ConcurrentMap(size_t bucket_count, const Allocator& allocator = Allocator())
+            : allocator_(allocator)
+            , sub_map_allocator_(allocator)
+            , bucket_count_(bucket_count)
+            , sub_maps(SubMapTraits::allocate(sub_map_allocator_, bucket_count)) {
+        for (size_t i = 0; i < bucket_count_; ++i) {
+            SubMapTraits::construct(sub_map_allocator_, sub_maps + i, allocator_);
+        }
+    };
 
-    Access operator[](const Key& key) {
-        uint64_t key_ = static_cast<uint64_t>(key) % sub_maps.size();
-        {
-            std::lock_guard guard(sub_maps[key_].sub_map_guard);
+    ConcurrentMap(const ConcurrentMap&) = delete;
+    ConcurrentMap& operator=(const ConcurrentMap&) = delete;
+
+    ~ConcurrentMap() {
+        for (size_t i = 0; i < bucket_count_; ++i) {
+            SubMapTraits::destroy(sub_map_allocator_, sub_maps + i);
         }
-        return {sub_maps[key_].sub_map_guard, key, sub_maps[key_].sub_map};
+        SubMapTraits::deallocate(sub_map_allocator_, sub_maps, bucket_count_);
+    }
+
+    Access operator[](const Key& key) {
+        NoStatsRecorder recorder;
+        return Get(key, recorder);
     };
 
-    std::map<Key, Value> BuildOrdinaryMap() {
-        std::map<Key, Value> result_map;
-        for (size_t i = 0; i < sub_maps.size(); ++i) {
+    //то же, что operator[], но учитывает захваты мьютекса и ожидания в recorder
+    template <typename Recorder>
+    Access Get(const Key& key, Recorder& recorder) {
+        uint64_t key_ = static_cast<uint64_t>(key) % bucket_count_;
+        std::mutex& guard = sub_maps[key_].sub_map_guard;
+        LockCounted(guard, recorder);
+        return {guard, key, sub_maps[key_].sub_map};
+    };
+
+    Map BuildOrdinaryMap() {
+        Map result_map(allocator_);
+        for (size_t i = 0; i < bucket_count_; ++i) {
             std::lock_guard<std::mutex> guard(sub_maps[i].sub_map_guard);
             for (const auto& [key, value] : sub_maps[i].sub_map) {
                 result_map[key] = value;
@@ -46,11 +78,18 @@ public:
     };
 
     auto Erase(const Key& key) {
-        uint64_t key_ = static_cast<uint64_t>(key) % sub_maps.size();
+        uint64_t key_ = static_cast<uint64_t>(key) % bucket_count_;
         std::lock_guard guard(sub_maps[key_].sub_map_guard);
         return sub_maps[key_].sub_map.erase(key);
     }
 
 private:
-    std::vector<SubMap<Key, Value>> sub_maps;
+    using SubMapType = SubMap<Key, Value, Allocator>;
+    using SubMapAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<SubMapType>;
+    using SubMapTraits = std::allocator_traits<SubMapAllocator>;
+
+    Allocator allocator_;
+    SubMapAllocator sub_map_allocator_;
+    size_t bucket_count_;
+    SubMapType* sub_maps;
 };
\ No newline at end of file
@@ -0,0 +1,148 @@
+#include "corpus_generator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <unordered_set>
+
+using namespace std;
+
+ZipfDistribution::ZipfDistribution(size_t size, double exponent) {
+    if (size == 0) {
+        throw invalid_argument("Zipf distribution size must be positive"s);
+    }
+    if (!isfinite(exponent)) {
+        throw invalid_argument("Zipf distribution exponent must be finite"s);
+    }
+    cumulative_.reserve(size);
+    double sum = 0;
+    for (size_t rank = 1; rank <= size; ++rank) {
+        sum += 1.0 / pow(static_cast<double>(rank), exponent);
+        cumulative_.push_back(sum);
+    }
+}
+
+size_t ZipfDistribution::operator()(mt19937& generator) const {
+    const double point = uniform_real_distribution<>(0, cumulative_.back())(generator);
+    const auto it = upper_bound(cumulative_.begin(), cumulative_.end(), point);
+    return min<size_t>(it - cumulative_.begin(), cumulative_.size() - 1);
+}
+
+namespace {
+
+//Слова уникальны и перемешаны, чтобы частота слова не зависела от его положения в алфавите
+vector<string> GenerateVocabulary(mt19937& generator, size_t word_count, int max_length) {
+    double possible_words = 0;
+    for (int length = 1; length <= max_length && possible_words < word_count; ++length) {
+        possible_words += pow(26.0, length);
+    }
+    if (possible_words < word_count) {
+        throw invalid_argument("Vocabulary size exceeds the number of possible words"s);
+    }
+    unordered_set<string> unique_words;
+    vector<string> words;
+    words.reserve(word_count);
+    while (words.size() < word_count) {
+        const int length = uniform_int_distribution(1, max_length)(generator);
+        string word;
+        word.reserve(length);
+        for (int i = 0; i < length; ++i) {
+            word.push_back(uniform_int_distribution('a', 'z')(generator));
+        }
+        if (unique_words.insert(word).second) {
+            words.push_back(move(word));
+        }
+    }
+    shuffle(words.begin(), words.end(), generator);
+    return words;
+}
+
+}
+
+CorpusGenerator::CorpusGenerator(const CorpusConfig& config, unsigned seed)
+    : config_(config)
+    , generator_(seed)
+    , vocabulary_(GenerateVocabulary(generator_, config.vocabulary_size, config.max_word_length))
+    , word_distribution_(vocabulary_.size(), config.zipf_exponent)
+    , length_distribution_(log(config.median_document_words), config.document_words_sigma)
+    , status_distribution_(config.status_weights.begin(), config.status_weights.end())
+    , rating_distribution_(config.mean_rating, config.rating_stddev)
+{
+}
+
+const vector<string>& CorpusGenerator::GetVocabulary() const {
+    return vocabulary_;
+}
+
+const ZipfDistribution& CorpusGenerator::GetWordDistribution() const {
+    return word_distribution_;
+}
+
+void CorpusGenerator::FeedDocuments(SearchServer& search_server, size_t count, int first_id) {
+    Generate(count, first_id, [&search_server](int document_id, string_view text, DocumentStatus status, const vector<int>& ratings) {
+        search_server.AddDocument(document_id, text, status, ratings);
+    });
+}
+
+void CorpusGenerator::GenerateNext() {
+    const int word_count = clamp(static_cast<int>(lround(length_distribution_(generator_))),
+                                 config_.min_document_words, config_.max_document_words);
+    text_.clear();
+    for (int i = 0; i < word_count; ++i) {
+        if (i > 0) {
+            text_.push_back(' ');
+        }
+        text_ += vocabulary_[word_distribution_(generator_)];
+    }
+
+    status_ = static_cast<DocumentStatus>(status_distribution_(generator_));
+
+    ratings_.resize(uniform_int_distribution(0, config_.max_ratings)(generator_));
+    for (int& rating : ratings_) {
+        rating = static_cast<int>(lround(rating_distribution_(generator_)));
+    }
+}
+
+QueryLogGenerator::QueryLogGenerator(const CorpusGenerator& corpus, const QueryLogConfig& config, unsigned seed)
+    : corpus_(corpus)
+    , config_(config)
+    , generator_(seed)
+    , hot_query_distribution_(max<size_t>(config.hot_query_count, 1), config.hot_query_zipf_exponent)
+{
+    hot_queries_.reserve(config_.hot_query_count);
+    for (size_t i = 0; i < config_.hot_query_count; ++i) {
+        hot_queries_.push_back(GenerateQuery());
+    }
+}
+
+string QueryLogGenerator::Next() {
+    if (!hot_queries_.empty() && uniform_real_distribution<>(0, 1)(generator_) < config_.hot_query_share) {
+        return hot_queries_[hot_query_distribution_(generator_)];
+    }
+    return GenerateQuery();
+}
+
+vector<string> QueryLogGenerator::Generate(size_t count) {
+    vector<string> queries;
+    queries.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        queries.push_back(Next());
+    }
+    return queries;
+}
+
+string QueryLogGenerator::GenerateQuery() {
+    const auto& vocabulary = corpus_.GetVocabulary();
+    const int word_count = uniform_int_distribution(config_.min_query_words, config_.max_query_words)(generator_);
+    string query;
+    for (int i = 0; i < word_count; ++i) {
+        if (!query.empty()) {
+            query.push_back(' ');
+        }
+        if (uniform_real_distribution<>(0, 1)(generator_) < config_.minus_prob) {
+            query.push_back('-');
+        }
+        query += vocabulary[corpus_.GetWordDistribution()(generator_)];
+    }
+    return query;
+}
\ No newline at end of file
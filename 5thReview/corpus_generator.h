@@ -0,0 +1,106 @@
+#pragma once
+
+#include "document.h"
+#include "search_server.h"
+
+#include <array>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+//Генераторы синтетического корпуса и журнала запросов для нагрузочного тестирования.
+//Частоты слов подчиняются закону Ципфа, длины документов - логнормальному распределению,
+//в журнале запросов часть запросов берётся из небольшого набора "горячих" запросов.
+//Документы генерируются по одному в переиспользуемый буфер, поэтому корпус любого размера
+//можно передать в AddDocument, не держа его в памяти целиком
+
+//Номер в диапазоне [0, size) с вероятностью ~ 1 / (номер + 1)^exponent; exponent == 0 - равномерное распределение
+//При size == 0 или бесконечном (NaN) exponent конструктор бросает invalid_argument
+class ZipfDistribution {
+public:
+    ZipfDistribution(size_t size, double exponent);
+
+    size_t operator()(std::mt19937& generator) const;
+
+private:
+    std::vector<double> cumulative_;
+};
+
+struct CorpusConfig {
+    size_t vocabulary_size = 10'000;
+    int max_word_length = 10;
+    double zipf_exponent = 1.0;
+    //длина документа в словах: логнормальное распределение с медианой median_document_words
+    double median_document_words = 70;
+    double document_words_sigma = 0.5;
+    int min_document_words = 1;
+    int max_document_words = 10'000;
+    //веса статусов в порядке ACTUAL, IRRELEVANT, BANNED, REMOVED
+    std::array<double, 4> status_weights = {0.85, 0.05, 0.05, 0.05};
+    int max_ratings = 5;
+    double mean_rating = 3.0;
+    double rating_stddev = 3.0;
+};
+
+class CorpusGenerator {
+public:
+    CorpusGenerator(const CorpusConfig& config, unsigned seed);
+
+    [[nodiscard]] const std::vector<std::string>& GetVocabulary() const;
+    [[nodiscard]] const ZipfDistribution& GetWordDistribution() const;
+
+    //Вызывает callback(document_id, text, status, ratings) для count документов с id от first_id.
+    //text и ratings действительны только до возврата из callback
+    template <typename Callback>
+    void Generate(size_t count, int first_id, Callback callback) {
+        for (size_t i = 0; i < count; ++i) {
+            GenerateNext();
+            callback(first_id + static_cast<int>(i), std::string_view(text_), status_, ratings_);
+        }
+    }
+
+    void FeedDocuments(SearchServer& search_server, size_t count, int first_id = 0);
+
+private:
+    CorpusConfig config_;
+    std::mt19937 generator_;
+    std::vector<std::string> vocabulary_;
+    ZipfDistribution word_distribution_;
+    std::lognormal_distribution<double> length_distribution_;
+    std::discrete_distribution<int> status_distribution_;
+    std::normal_distribution<double> rating_distribution_;
+
+    std::string text_;
+    DocumentStatus status_ = DocumentStatus::ACTUAL;
+    std::vector<int> ratings_;
+
+    void GenerateNext();
+};
+
+struct QueryLogConfig {
+    int min_query_words = 1;
+    int max_query_words = 5;
+    double minus_prob = 0.1;
+    //доля запросов из набора горячих запросов, популярность которых тоже распределена по Ципфу
+    size_t hot_query_count = 1'000;
+    double hot_query_share = 0.8;
+    double hot_query_zipf_exponent = 1.0;
+};
+
+class QueryLogGenerator {
+public:
+    QueryLogGenerator(const CorpusGenerator& corpus, const QueryLogConfig& config, unsigned seed);
+
+    std::string Next();
+    std::vector<std::string> Generate(size_t count);
+
+private:
+    const CorpusGenerator& corpus_;
+    QueryLogConfig config_;
+    std::mt19937 generator_;
+    std::vector<std::string> hot_queries_;
+    ZipfDistribution hot_query_distribution_;
+
+    std::string GenerateQuery();
+};
\ No newline at end of file
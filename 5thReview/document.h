@@ -1,6 +1,8 @@
 #pragma once
 
 #include <iostream>
+#include <string_view>
+#include <vector>
 
 struct Document {
     Document() = default;
@@ -23,4 +25,22 @@ enum class DocumentStatus {
     REMOVED,
 };
 
+//Предикат "документ имеет статус status". SearchServer распознаёт его на этапе компиляции
+//и проверяет статус по битовым картам, не обращаясь к данным документа
+struct StatusFilter {
+    DocumentStatus status = DocumentStatus::ACTUAL;
+
+    bool operator()(int /*document_id*/, DocumentStatus document_status, int /*rating*/) const {
+        return document_status == status;
+    }
+};
+
+//Документ для пакетного добавления, текст ссылается на внешний буфер (например, отображённый в память файл)
+struct RawDocument {
+    int id = 0;
+    std::string_view text;
+    DocumentStatus status = DocumentStatus::ACTUAL;
+    std::vector<int> ratings;
+};
+
 std::ostream& operator<<(std::ostream& out, const Document& document);
\ No newline at end of file
@@ -0,0 +1,371 @@
+#include "document_reader.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <execution>
+#include <future>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+MappedFile::MappedFile(const string& path) {
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw runtime_error("Cannot open "s + path);
+    }
+    struct stat file_stat {};
+    if (fstat(fd, &file_stat) != 0) {
+        close(fd);
+        throw runtime_error("Cannot stat "s + path);
+    }
+    size_ = static_cast<size_t>(file_stat.st_size);
+    if (size_ > 0) {
+        void* data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            close(fd);
+            throw runtime_error("Cannot map "s + path);
+        }
+        madvise(data, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const char*>(data);
+    }
+    close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (data_ != nullptr) {
+        munmap(const_cast<char*>(data_), size_);
+    }
+}
+
+string_view MappedFile::GetData() const {
+    return { data_, size_ };
+}
+
+namespace {
+
+//те же символы отвергает SearchServer::IsValidWord
+bool IsControlChar(char c) {
+    return c >= '\0' && c < ' ';
+}
+
+DocumentStatus ParseStatus(string_view text) {
+    if (text == "ACTUAL"sv || text == "0"sv) return DocumentStatus::ACTUAL;
+    if (text == "IRRELEVANT"sv || text == "1"sv) return DocumentStatus::IRRELEVANT;
+    if (text == "BANNED"sv || text == "2"sv) return DocumentStatus::BANNED;
+    if (text == "REMOVED"sv || text == "3"sv) return DocumentStatus::REMOVED;
+    throw invalid_argument("Unknown document status "s + string(text));
+}
+
+int ParseInt(string_view text) {
+    int value = 0;
+    const auto [end, error] = from_chars(text.data(), text.data() + text.size(), value);
+    if (error != errc() || end != text.data() + text.size()) {
+        throw invalid_argument("Invalid number "s + string(text));
+    }
+    return value;
+}
+
+//Числа, разделённые пробелами или запятыми
+void ParseRatings(string_view text, vector<int>& ratings) {
+    ratings.clear();
+    while (true) {
+        const auto start = text.find_first_not_of(" ,"sv);
+        if (start == text.npos) {
+            return;
+        }
+        text.remove_prefix(start);
+        const auto end = text.find_first_of(" ,"sv);
+        ratings.push_back(ParseInt(text.substr(0, end)));
+        if (end == text.npos) {
+            return;
+        }
+        text.remove_prefix(end);
+    }
+}
+
+string_view NextField(string_view& line) {
+    const auto tab = line.find('\t');
+    if (tab == line.npos) {
+        throw invalid_argument("Expected id, status, ratings and text separated by tabs"s);
+    }
+    const string_view field = line.substr(0, tab);
+    line.remove_prefix(tab + 1);
+    return field;
+}
+
+void ParseTsvLine(string_view line, RawDocument& document) {
+    document.id = ParseInt(NextField(line));
+    document.status = ParseStatus(NextField(line));
+    ParseRatings(NextField(line), document.ratings);
+    document.text = line;
+}
+
+//Минимальный разбор плоского JSON-объекта: строки, числа, массивы чисел
+class JsonLineParser {
+public:
+    JsonLineParser(string_view line, deque<string>& unescaped_texts)
+        : text_(line)
+        , unescaped_texts_(unescaped_texts) {
+    }
+
+    void Parse(RawDocument& document) {
+        Expect('{');
+        bool has_id = false;
+        if (!TryConsume('}')) {
+            do {
+                const string_view key = ParseString();
+                Expect(':');
+                if (key == "id"sv) {
+                    document.id = ParseInt(ParseNumber());
+                    has_id = true;
+                } else if (key == "status"sv) {
+                    SkipSpaces();
+                    document.status = ParseStatus(Peek() == '"' ? ParseString() : ParseNumber());
+                } else if (key == "ratings"sv) {
+                    ParseRatingsArray(document.ratings);
+                } else if (key == "text"sv) {
+                    document.text = ParseString();
+                } else {
+                    SkipValue();
+                }
+            } while (TryConsume(','));
+            Expect('}');
+        }
+        if (!has_id) {
+            throw invalid_argument("Document has no id"s);
+        }
+    }
+
+private:
+    string_view text_;
+    deque<string>& unescaped_texts_;
+
+    void SkipSpaces() {
+        while (!text_.empty() && (text_.front() == ' ' || text_.front() == '\t' || text_.front() == '\r')) {
+            text_.remove_prefix(1);
+        }
+    }
+
+    char Peek() const {
+        return text_.empty() ? '\0' : text_.front();
+    }
+
+    bool TryConsume(char c) {
+        SkipSpaces();
+        if (Peek() == c) {
+            text_.remove_prefix(1);
+            return true;
+        }
+        return false;
+    }
+
+    void Expect(char c) {
+        if (!TryConsume(c)) {
+            throw invalid_argument("Expected '"s + c + "' in JSON"s);
+        }
+    }
+
+    string_view ParseNumber() {
+        SkipSpaces();
+        const auto end = text_.find_first_of(",]} \t\r"sv);
+        const string_view number = text_.substr(0, end);
+        text_.remove_prefix(number.size());
+        return number;
+    }
+
+    //строка без escape-последовательностей и управляющих символов возвращается как string_view в исходную строку
+    string_view ParseString() {
+        Expect('"');
+        const auto end = text_.find_first_of("\"\\"sv);
+        if (end == text_.npos) {
+            throw invalid_argument("Unterminated JSON string"s);
+        }
+        const string_view prefix = text_.substr(0, end);
+        const auto control = find_if(prefix.begin(), prefix.end(), IsControlChar);
+        if (text_[end] == '"' && control == prefix.end()) {
+            text_.remove_prefix(end + 1);
+            return prefix;
+        }
+        const size_t copied = control - prefix.begin();
+        string& result = unescaped_texts_.emplace_back(text_.substr(0, copied));
+        text_.remove_prefix(copied);
+        while (!text_.empty() && text_.front() != '"') {
+            if (text_.front() != '\\') {
+                result.push_back(IsControlChar(text_.front()) ? ' ' : text_.front());
+                text_.remove_prefix(1);
+                continue;
+            }
+            if (text_.size() < 2) {
+                throw invalid_argument("Unterminated JSON string"s);
+            }
+            const char escaped = text_[1];
+            text_.remove_prefix(2);
+            switch (escaped) {
+                //управляющие символы в словах запрещены, поэтому становятся разделителями слов
+                case 'n':
+                case 't':
+                case 'r':
+                case 'b':
+                case 'f': result.push_back(' '); break;
+                case 'u': {
+                    unsigned code = ParseHexCode();
+                    //символ вне базовой плоскости записывается парой суррогатов \uD8xx\uDCxx
+                    if (code >= 0xD800 && code <= 0xDBFF) {
+                        if (text_.substr(0, 2) != "\\u"sv) {
+                            throw invalid_argument("Invalid JSON surrogate pair"s);
+                        }
+                        text_.remove_prefix(2);
+                        const unsigned low = ParseHexCode();
+                        if (low < 0xDC00 || low > 0xDFFF) {
+                            throw invalid_argument("Invalid JSON surrogate pair"s);
+                        }
+                        code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    } else if (code >= 0xDC00 && code <= 0xDFFF) {
+                        throw invalid_argument("Invalid JSON surrogate pair"s);
+                    }
+                    AppendUtf8(result, code < ' ' ? ' ' : code);
+                    break;
+                }
+                default: result.push_back(escaped);
+            }
+        }
+        if (text_.empty()) {
+            throw invalid_argument("Unterminated JSON string"s);
+        }
+        text_.remove_prefix(1);
+        return result;
+    }
+
+    void ParseRatingsArray(vector<int>& ratings) {
+        ratings.clear();
+        Expect('[');
+        if (TryConsume(']')) {
+            return;
+        }
+        do {
+            ratings.push_back(ParseInt(ParseNumber()));
+        } while (TryConsume(','));
+        Expect(']');
+    }
+
+    void SkipValue() {
+        SkipSpaces();
+        if (Peek() == '"') {
+            ParseString();
+        } else if (Peek() == '[') {
+            text_.remove_prefix(1);
+            if (!TryConsume(']')) {
+                do {
+                    SkipValue();
+                } while (TryConsume(','));
+                Expect(']');
+            }
+        } else {
+            ParseNumber();
+        }
+    }
+
+    //четыре шестнадцатеричные цифры после \u
+    unsigned ParseHexCode() {
+        unsigned code = 0;
+        const char* const end = text_.data() + min<size_t>(text_.size(), 4);
+        const auto [ptr, ec] = from_chars(text_.data(), end, code, 16);
+        if (ec != errc{} || ptr != text_.data() + 4) {
+            throw invalid_argument("Invalid JSON escape"s);
+        }
+        text_.remove_prefix(4);
+        return code;
+    }
+
+    static void AppendUtf8(string& out, unsigned code) {
+        if (code < 0x80) {
+            out.push_back(static_cast<char>(code));
+        } else if (code < 0x800) {
+            out.push_back(static_cast<char>(0xC0 | (code >> 6)));
+            out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        } else if (code < 0x10000) {
+            out.push_back(static_cast<char>(0xE0 | (code >> 12)));
+            out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        } else {
+            out.push_back(static_cast<char>(0xF0 | (code >> 18)));
+            out.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        }
+    }
+};
+
+}
+
+DocumentFileReader::DocumentFileReader(const string& path, DocumentFileFormat format)
+    : file_(path)
+    , rest_(file_.GetData())
+    , format_(format)
+{
+}
+
+bool DocumentFileReader::ReadBatch(size_t batch_size, DocumentBatch& batch) {
+    batch.unescaped_texts.clear();
+    size_t count = 0;
+    while (count < batch_size && !rest_.empty()) {
+        const auto newline = rest_.find('\n');
+        string_view line = rest_.substr(0, newline);
+        rest_.remove_prefix(newline == rest_.npos ? rest_.size() : newline + 1);
+        ++line_number_;
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        if (line.empty()) {
+            continue;
+        }
+
+        //элементы партии переиспользуются, чтобы не выделять заново векторы рейтингов
+        if (count == batch.documents.size()) {
+            batch.documents.emplace_back();
+        }
+        RawDocument& document = batch.documents[count];
+        document = { 0, {}, DocumentStatus::ACTUAL, move(document.ratings) };
+        try {
+            if (format_ == DocumentFileFormat::TSV) {
+                ParseTsvLine(line, document);
+            } else {
+                JsonLineParser(line, batch.unescaped_texts).Parse(document);
+            }
+        } catch (const invalid_argument& e) {
+            throw invalid_argument("Line "s + to_string(line_number_) + ": "s + e.what());
+        }
+        ++count;
+    }
+    batch.documents.resize(count);
+    return count > 0;
+}
+
+size_t LoadDocuments(SearchServer& search_server, const string& path, DocumentFileFormat format, size_t batch_size) {
+    DocumentFileReader reader(path, format);
+    DocumentBatch current;
+    DocumentBatch next;
+    size_t loaded = 0;
+    bool has_batch = reader.ReadBatch(batch_size, current);
+    while (has_batch) {
+        auto next_ready = async(launch::async, [&reader, &next, batch_size] {
+            return reader.ReadBatch(batch_size, next);
+        });
+        try {
+            search_server.AddDocuments(execution::par, current.documents);
+        } catch (...) {
+            next_ready.wait();
+            throw;
+        }
+        loaded += current.documents.size();
+        has_batch = next_ready.get();
+        swap(current, next);
+    }
+    return loaded;
+}
\ No newline at end of file
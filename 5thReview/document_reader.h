@@ -0,0 +1,63 @@
+#pragma once
+
+#include "document.h"
+#include "search_server.h"
+
+#include <deque>
+#include <string>
+#include <string_view>
+#include <vector>
+
+//Потоковое чтение корпуса из файла без выделения строки на документ.
+//Файл отображается в память (mmap), тексты документов - string_view в отображение.
+//Форматы, по одному документу в строке:
+//  TSV:   id<TAB>status<TAB>ratings<TAB>text, status - имя (ACTUAL) или номер, ratings - числа через пробел или запятую
+//  JSONL: {"id": 1, "status": "ACTUAL", "ratings": [1, 2], "text": "..."}
+//Копируются только тексты JSON с escape-последовательностями
+
+enum class DocumentFileFormat {
+    TSV,
+    JSONL,
+};
+
+//Отображение файла в память только для чтения
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    [[nodiscard]] std::string_view GetData() const;
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+//Партия документов; тексты действительны, пока живы партия и файл
+struct DocumentBatch {
+    std::vector<RawDocument> documents;
+    std::deque<std::string> unescaped_texts;
+};
+
+class DocumentFileReader {
+public:
+    DocumentFileReader(const std::string& path, DocumentFileFormat format);
+
+    //Читает до batch_size документов в batch. Возвращает false, когда файл прочитан.
+    //При ошибке разбора выбрасывает invalid_argument с номером строки
+    bool ReadBatch(size_t batch_size, DocumentBatch& batch);
+
+private:
+    MappedFile file_;
+    std::string_view rest_;
+    DocumentFileFormat format_;
+    size_t line_number_ = 0;
+};
+
+//Загружает документы файла в search_server. Чтение и разбор следующей партии идут в отдельном потоке
+//одновременно с добавлением текущей, разбиение текстов на слова внутри партии - параллельное.
+//Возвращает число добавленных документов
+size_t LoadDocuments(SearchServer& search_server, const std::string& path, DocumentFileFormat format, size_t batch_size = 10'000);
\ No newline at end of file
@@ -1,85 +1,369 @@
-#include <process_queries.h>
+#include "corpus_generator.h"
+#include "process_queries.h"
+#include "remove_duplicates.h"
 #include "search_server.h"
-#include "log_duration.h"
+#include "search_server_tests.h"
 
+#include <algorithm>
+#include <chrono>
 #include <execution>
 #include <iostream>
+#include <map>
+#include <numeric>
 #include <random>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
 using namespace std;
 
-string GenerateWord(mt19937& generator, int max_length) {
-    const int length = uniform_int_distribution(1, max_length)(generator);
-    string word;
-    word.reserve(length);
-    for (int i = 0; i < length; ++i) {
-        word.push_back(uniform_int_distribution('a', 'z')(generator));
+//Набор воспроизводимых замеров SearchServer на синтетических данных.
+//Параметры задаются аргументами вида ключ=значение[,значение...], по спискам значений строится перебор.
+//Повторяющиеся значения в списке учитываются один раз.
+//  preset=quick|full     набор значений по умолчанию: quick (по умолчанию) - малый корпус и один повтор,
+//                        прогон занимает секунды; full - корпус 10000 документов и 5 повторов, прогон на десятки минут.
+//                        Параметры после preset переопределяют его значения
+//  docs=10000,50000      размер корпуса
+//  doc_words=70          медиана числа слов в документе
+//  query_words=3,10      слов в запросе
+//  minus=0,0.2           вероятность минус-слова в запросе
+//  zipf=0,1              показатель распределения Ципфа для словаря (0 - равномерное)
+//  hot=0                 доля повторяющихся горячих запросов в журнале запросов
+//  threads=1,4           число потоков для замера пропускной способности поиска
+//  queries=200 dictionary=10000 reps=1 warmup=0 seed=42 format=csv|json
+//Каждый замер выполняется warmup раз без учёта и reps раз с учётом,
+//результат выводится по одной строке на метрику
+
+using Clock = chrono::steady_clock;
+
+//значения по умолчанию - набор quick
+struct BenchmarkConfig {
+    vector<int> docs = {2'000};
+    vector<int> doc_words = {70};
+    vector<int> query_words = {3, 10};
+    vector<double> minus = {0.0, 0.2};
+    vector<double> zipf = {0.0, 1.0};
+    vector<double> hot = {0.0};
+    vector<int> threads = {1, static_cast<int>(max(1u, thread::hardware_concurrency()))};
+    int queries = 200;
+    int dictionary = 10'000;
+    int reps = 1;
+    int warmup = 0;
+    unsigned seed = 42;
+    string format = "csv"s;
+};
+
+BenchmarkConfig MakePreset(const string& name) {
+    BenchmarkConfig config;
+    if (name == "full"s) {
+        config.docs = {10'000};
+        config.queries = 1'000;
+        config.reps = 5;
+        config.warmup = 1;
+    } else if (name != "quick"s) {
+        throw invalid_argument("Unknown preset "s + name);
+    }
+    return config;
+}
+
+//оставляет первое вхождение каждого значения, порядок перебора сохраняется
+template <typename Number>
+void RemoveRepeats(vector<Number>& values) {
+    vector<Number> unique_values;
+    for (const Number value : values) {
+        if (find(unique_values.begin(), unique_values.end(), value) == unique_values.end()) {
+            unique_values.push_back(value);
+        }
     }
-    return word;
+    values = move(unique_values);
 }
 
-vector<string> GenerateDictionary(mt19937& generator, int word_count, int max_length) {
-    vector<string> words;
-    words.reserve(word_count);
-    for (int i = 0; i < word_count; ++i) {
-        words.push_back(GenerateWord(generator, max_length));
+template <typename Number>
+vector<Number> ParseList(const string& text) {
+    vector<Number> values;
+    istringstream in(text);
+    for (string item; getline(in, item, ',');) {
+        istringstream item_in(item);
+        Number value{};
+        item_in >> value;
+        values.push_back(value);
     }
-    words.erase(unique(words.begin(), words.end()), words.end());
-    return words;
+    return values;
 }
 
-string GenerateQuery(mt19937& generator, const vector<string>& dictionary, int word_count, double minus_prob = 0) {
-    string query;
-    for (int i = 0; i < word_count; ++i) {
-        if (!query.empty()) {
-            query.push_back(' ');
+BenchmarkConfig ParseConfig(int argc, char* argv[]) {
+    BenchmarkConfig config;
+    for (int i = 1; i < argc; ++i) {
+        const string arg = argv[i];
+        const auto eq = arg.find('=');
+        if (eq == string::npos) {
+            throw invalid_argument("Expected key=value, got "s + arg);
         }
-        if (uniform_real_distribution<>(0, 1)(generator) < minus_prob) {
-            query.push_back('-');
+        const string key = arg.substr(0, eq);
+        const string value = arg.substr(eq + 1);
+        if (key == "preset"s) config = MakePreset(value);
+        else if (key == "docs"s) config.docs = ParseList<int>(value);
+        else if (key == "doc_words"s) config.doc_words = ParseList<int>(value);
+        else if (key == "query_words"s) config.query_words = ParseList<int>(value);
+        else if (key == "minus"s) config.minus = ParseList<double>(value);
+        else if (key == "zipf"s) config.zipf = ParseList<double>(value);
+        else if (key == "hot"s) config.hot = ParseList<double>(value);
+        else if (key == "threads"s) config.threads = ParseList<int>(value);
+        else if (key == "queries"s) config.queries = stoi(value);
+        else if (key == "dictionary"s) config.dictionary = stoi(value);
+        else if (key == "reps"s) config.reps = stoi(value);
+        else if (key == "warmup"s) config.warmup = stoi(value);
+        else if (key == "seed"s) config.seed = static_cast<unsigned>(stoul(value));
+        else if (key == "format"s) config.format = value;
+        else throw invalid_argument("Unknown parameter "s + key);
+    }
+    //при одном ядре threads=1,1 повторял бы те же замеры
+    RemoveRepeats(config.docs);
+    RemoveRepeats(config.doc_words);
+    RemoveRepeats(config.query_words);
+    RemoveRepeats(config.minus);
+    RemoveRepeats(config.zipf);
+    RemoveRepeats(config.hot);
+    RemoveRepeats(config.threads);
+    return config;
+}
+
+class Reporter {
+public:
+    explicit Reporter(string format) : format_(move(format)) {
+        if (format_ == "csv"s) {
+            cout << "benchmark,docs,doc_words,zipf,query_words,minus,hot,threads,metric,value"s << endl;
         }
-        query += dictionary[uniform_int_distribution<int>(0, dictionary.size() - 1)(generator)];
     }
-    return query;
+
+    void Report(const string& benchmark, const map<string, double>& params, const string& metric, double value) const {
+        const auto param = [&params](const string& name) {
+            const auto it = params.find(name);
+            return it == params.end() ? ""s : FormatNumber(it->second);
+        };
+        if (format_ == "json"s) {
+            cout << "{\"benchmark\":\""s << benchmark << '"';
+            for (const auto& [name, param_value] : params) {
+                cout << ",\""s << name << "\":"s << FormatNumber(param_value);
+            }
+            cout << ",\"metric\":\""s << metric << "\",\"value\":"s << FormatNumber(value) << '}' << endl;
+        } else {
+            cout << benchmark << ',' << param("docs"s) << ',' << param("doc_words"s) << ',' << param("zipf"s) << ','
+                 << param("query_words"s) << ',' << param("minus"s) << ',' << param("hot"s) << ',' << param("threads"s) << ','
+                 << metric << ',' << FormatNumber(value) << endl;
+        }
+    }
+
+private:
+    string format_;
+
+    static string FormatNumber(double value) {
+        ostringstream out;
+        out.precision(12);
+        out << value;
+        return out.str();
+    }
+};
+
+double Percentile(vector<double> values, double percent) {
+    if (values.empty()) {
+        return 0;
+    }
+    sort(values.begin(), values.end());
+    return values[static_cast<size_t>((values.size() - 1) * percent / 100.0)];
 }
 
-vector<string> GenerateQueries(mt19937& generator, const vector<string>& dictionary, int query_count, int max_word_count) {
-    vector<string> queries;
-    queries.reserve(query_count);
-    for (int i = 0; i < query_count; ++i) {
-        queries.push_back(GenerateQuery(generator, dictionary, max_word_count));
+double Median(vector<double> values) {
+    return Percentile(move(values), 50);
+}
+
+template <typename Function>
+double MeasureSeconds(Function function) {
+    const auto start = Clock::now();
+    function();
+    return chrono::duration<double>(Clock::now() - start).count();
+}
+
+//Прогоняет замер warmup + reps раз и возвращает времена учитываемых прогонов
+template <typename Function>
+vector<double> Repeat(const BenchmarkConfig& config, Function function) {
+    for (int i = 0; i < config.warmup; ++i) {
+        function();
+    }
+    vector<double> seconds;
+    for (int i = 0; i < config.reps; ++i) {
+        seconds.push_back(MeasureSeconds(function));
     }
-    return queries;
+    return seconds;
 }
 
-template <typename ExecutionPolicy>
-void Test(string_view mark, const SearchServer& search_server, const vector<string>& queries, ExecutionPolicy&& policy) {
-    LOG_DURATION(mark);
-    double total_relevance = 0;
-    for (const string_view query : queries) {
-        for (const auto& document : search_server.FindTopDocuments(policy, query)) {
-            total_relevance += document.relevance;
+void ReportLatencies(const Reporter& reporter, const string& benchmark, const map<string, double>& params, vector<double> latencies_ns) {
+    reporter.Report(benchmark, params, "mean_ns"s, accumulate(latencies_ns.begin(), latencies_ns.end(), 0.0) / max<size_t>(latencies_ns.size(), 1));
+    reporter.Report(benchmark, params, "p50_ns"s, Percentile(latencies_ns, 50));
+    reporter.Report(benchmark, params, "p90_ns"s, Percentile(latencies_ns, 90));
+    reporter.Report(benchmark, params, "p99_ns"s, Percentile(latencies_ns, 99));
+}
+
+template <typename ExecutionPolicy, typename RankingPolicy = TfIdfRanking>
+vector<double> MeasureQueryLatencies(const BenchmarkConfig& config, const SearchServer& search_server, const vector<string>& queries, ExecutionPolicy policy,
+                                     const RankingPolicy& ranking = {}) {
+    vector<double> latencies_ns;
+    latencies_ns.reserve(queries.size() * config.reps);
+    for (int rep = 0; rep < config.warmup + config.reps; ++rep) {
+        for (const string& query : queries) {
+            const auto start = Clock::now();
+            const auto documents = search_server.FindTopDocuments(policy, query, DocumentStatus::ACTUAL, ranking);
+            const auto end = Clock::now();
+            if (rep >= config.warmup) {
+                latencies_ns.push_back(chrono::duration<double, nano>(end - start).count());
+            }
         }
     }
-    cout << total_relevance << endl;
+    return latencies_ns;
+}
+
+//Пропускная способность при обработке запросов заданным числом потоков
+double MeasureThreadedThroughput(const BenchmarkConfig& config, const SearchServer& search_server, const vector<string>& queries, int thread_count) {
+    const auto seconds = Repeat(config, [&] {
+        vector<thread> threads;
+        for (int t = 0; t < thread_count; ++t) {
+            threads.emplace_back([&, t] {
+                for (size_t i = t; i < queries.size(); i += thread_count) {
+                    const auto documents = search_server.FindTopDocuments(queries[i]);
+                }
+            });
+        }
+        for (thread& worker : threads) {
+            worker.join();
+        }
+    });
+    return queries.size() / Median(seconds);
 }
 
-#define TEST(policy) Test(#policy, search_server, queries, execution::policy)
+void RunCorpusBenchmarks(const BenchmarkConfig& config, const Reporter& reporter, int doc_count, int doc_words, double zipf) {
+    CorpusConfig corpus_config;
+    corpus_config.vocabulary_size = config.dictionary;
+    corpus_config.zipf_exponent = zipf;
+    corpus_config.median_document_words = doc_words;
+    CorpusGenerator corpus(corpus_config, config.seed);
+
+    //документы генерируются заранее, чтобы время генерации не попадало в замер индексации
+    struct GeneratedDocument {
+        string text;
+        DocumentStatus status;
+        vector<int> ratings;
+    };
+    vector<GeneratedDocument> documents;
+    documents.reserve(doc_count);
+    corpus.Generate(doc_count, 0, [&documents](int, string_view text, DocumentStatus status, const vector<int>& ratings) {
+        documents.push_back({string(text), status, ratings});
+    });
+    const string stop_word = corpus.GetVocabulary()[0];
+    map<string, double> params = {{"docs"s, doc_count}, {"doc_words"s, doc_words}, {"zipf"s, zipf}};
+
+    const auto build_server = [&] {
+        SearchServer search_server(stop_word);
+        for (size_t i = 0; i < documents.size(); ++i) {
+            search_server.AddDocument(static_cast<int>(i), documents[i].text, documents[i].status, documents[i].ratings);
+        }
+        return search_server;
+    };
+
+    const auto ingestion = Repeat(config, [&] { build_server(); });
+    reporter.Report("ingestion"s, params, "docs_per_sec"s, doc_count / Median(ingestion));
+
+    const SearchServer search_server = build_server();
+    for (const int query_words : config.query_words) {
+        for (const double minus : config.minus) {
+            for (const double hot : config.hot) {
+                auto query_params = params;
+                query_params["query_words"s] = query_words;
+                query_params["minus"s] = minus;
+                query_params["hot"s] = hot;
+                QueryLogConfig query_config;
+                query_config.min_query_words = query_config.max_query_words = query_words;
+                query_config.minus_prob = minus;
+                query_config.hot_query_share = hot;
+                const auto queries = QueryLogGenerator(corpus, query_config, config.seed).Generate(config.queries);
 
-int main() {
-    mt19937 generator;
+                ReportLatencies(reporter, "find_seq"s, query_params, MeasureQueryLatencies(config, search_server, queries, execution::seq));
+                ReportLatencies(reporter, "find_par"s, query_params, MeasureQueryLatencies(config, search_server, queries, execution::par));
+                ReportLatencies(reporter, "find_seq_bm25"s, query_params, MeasureQueryLatencies(config, search_server, queries, execution::seq, Bm25Ranking{}));
 
-    const auto dictionary = GenerateDictionary(generator, 1000, 10);
-    const auto documents = GenerateQueries(generator, dictionary, 10'000, 70);
+                const auto process = Repeat(config, [&] { ProcessQueries(search_server, queries); });
+                reporter.Report("process_queries"s, query_params, "queries_per_sec"s, queries.size() / Median(process));
 
-    SearchServer search_server(dictionary[0]);
-    for (size_t i = 0; i < documents.size(); ++i) {
-        search_server.AddDocument(i, documents[i], DocumentStatus::ACTUAL, {1, 2, 3});
+                for (const int thread_count : config.threads) {
+                    auto thread_params = query_params;
+                    thread_params["threads"s] = thread_count;
+                    reporter.Report("find_threads"s, thread_params, "queries_per_sec"s,
+                                    MeasureThreadedThroughput(config, search_server, queries, thread_count));
+                }
+
+                vector<double> match_latencies;
+                mt19937 generator(config.seed);
+                uniform_int_distribution<int> document_id(0, doc_count - 1);
+                for (int rep = 0; rep < config.warmup + config.reps; ++rep) {
+                    for (const string& query : queries) {
+                        const int id = document_id(generator);
+                        const auto start = Clock::now();
+                        const auto matched = search_server.MatchDocument(query, id);
+                        const auto end = Clock::now();
+                        if (rep >= config.warmup) {
+                            match_latencies.push_back(chrono::duration<double, nano>(end - start).count());
+                        }
+                    }
+                }
+                ReportLatencies(reporter, "match_document"s, query_params, move(match_latencies));
+            }
+        }
     }
 
-    const auto queries = GenerateQueries(generator, dictionary, 100, 70);
+    //удаление каждого десятого документа, на копии индекса для каждого прогона
+    vector<double> remove_latencies;
+    for (int rep = 0; rep < config.warmup + config.reps; ++rep) {
+        SearchServer copy = build_server();
+        for (int id = 0; id < doc_count; id += 10) {
+            const auto start = Clock::now();
+            copy.RemoveDocument(id);
+            const auto end = Clock::now();
+            if (rep >= config.warmup) {
+                remove_latencies.push_back(chrono::duration<double, nano>(end - start).count());
+            }
+        }
+    }
+    ReportLatencies(reporter, "remove_document"s, params, move(remove_latencies));
 
-    TEST(seq);
-    TEST(par);
+    //корпус, в котором каждый десятый документ повторяет другой документ
+    vector<double> dedup_seconds;
+    for (int rep = 0; rep < config.warmup + config.reps; ++rep) {
+        SearchServer with_duplicates = build_server();
+        for (int i = 0; i < doc_count / 10; ++i) {
+            with_duplicates.AddDocument(doc_count + i, documents[i].text, documents[i].status, documents[i].ratings);
+        }
+        const double seconds = MeasureSeconds([&] { RemoveDuplicates(with_duplicates); });
+        if (rep >= config.warmup) {
+            dedup_seconds.push_back(seconds);
+        }
+    }
+    reporter.Report("remove_duplicates"s, params, "docs_per_sec"s, (doc_count + doc_count / 10) / Median(dedup_seconds));
+}
+
+int main(int argc, char* argv[]) {
+    TestSearchServer();
+    try {
+        const BenchmarkConfig config = ParseConfig(argc, argv);
+        const Reporter reporter(config.format);
+        for (const int doc_count : config.docs) {
+            for (const int doc_words : config.doc_words) {
+                for (const double zipf : config.zipf) {
+                    RunCorpusBenchmarks(config, reporter, doc_count, doc_words, zipf);
+                }
+            }
+        }
+    } catch (const exception& e) {
+        cerr << e.what() << endl;
+        return 1;
+    }
 }
\ No newline at end of file
@@ -2,9 +2,33 @@
 #include <iostream>
 #include <vector>
 #include <algorithm>
+#include <iterator>
+#include <type_traits>
 
 //Класс-шаблон, разбивающий результаты запроса на страницы,
-//"страница" - два итератора с указанием на начало и конец диапозона в контейнере
+//"страница" - два итератора с указанием на начало и конец диапозона в контейнере.
+//Границы страниц вычисляются лениво, при обходе: для итераторов произвольного доступа
+//переход к странице N выполняется за O(1), для однонаправленных - за O(N * page_size)
+
+template <typename Iterator>
+constexpr bool IS_RANDOM_ACCESS_ITERATOR = std::is_base_of_v<std::random_access_iterator_tag,
+        typename std::iterator_traits<Iterator>::iterator_category>;
+
+//Сдвигает итератор на count позиций, но не дальше end. Возвращает число сделанных шагов
+template <typename Iterator>
+size_t AdvanceBounded(Iterator& it, size_t count, Iterator end) {
+    if constexpr (IS_RANDOM_ACCESS_ITERATOR<Iterator>) {
+        const size_t steps = std::min(count, static_cast<size_t>(end - it));
+        it += steps;
+        return steps;
+    } else {
+        size_t steps = 0;
+        for (; steps < count && it != end; ++steps) {
+            ++it;
+        }
+        return steps;
+    }
+}
 
 template <typename Iterator>
 class IteratorRange {
@@ -13,7 +37,13 @@ public:
     IteratorRange(Iterator begin, Iterator end)
             : first_(begin)
             , last_(end)
-            , size_(distance(first_, last_)) {
+            , size_(std::distance(first_, last_)) {
+    }
+
+    IteratorRange(Iterator begin, Iterator end, size_t size)
+            : first_(begin)
+            , last_(end)
+            , size_(size) {
     }
 
     Iterator begin() const {
@@ -44,34 +74,177 @@ std::ostream& operator<<(std::ostream& out, const IteratorRange<Iterator>& range
 template <typename Iterator>
 class Paginator {
 public:
-    Paginator(Iterator begin, Iterator end, size_t page_size) {
-        for (size_t left = distance(begin, end); left > 0;) {
-            const size_t current_page_size = std::min(page_size, left);
-            const Iterator current_page_end = next(begin, current_page_size);
-            pages_.push_back({begin, current_page_end});
-
-            left -= current_page_size;
-            begin = current_page_end;
+    //Итератор по страницам, конец следующей страницы ищется только при переходе к ней
+    class PageIterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = IteratorRange<Iterator>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = value_type;
+
+        PageIterator(Iterator page_begin, Iterator end, size_t page_size)
+                : page_begin_(page_begin)
+                , page_end_(page_begin)
+                , end_(end)
+                , page_size_(page_size)
+                , current_size_(AdvanceBounded(page_end_, page_size_, end_)) {
+        }
+
+        value_type operator*() const {
+            return {page_begin_, page_end_, current_size_};
+        }
+
+        PageIterator& operator++() {
+            page_begin_ = page_end_;
+            current_size_ = AdvanceBounded(page_end_, page_size_, end_);
+            return *this;
+        }
+
+        PageIterator operator++(int) {
+            PageIterator old_value(*this);
+            ++(*this);
+            return old_value;
+        }
+
+        bool operator==(const PageIterator& rhs) const {
+            return page_begin_ == rhs.page_begin_;
+        }
+
+        bool operator!=(const PageIterator& rhs) const {
+            return !(*this == rhs);
         }
+
+    private:
+        Iterator page_begin_, page_end_, end_;
+        size_t page_size_;
+        size_t current_size_;
+    };
+
+    Paginator(Iterator begin, Iterator end, size_t page_size)
+            : begin_(begin)
+            , end_(end)
+            , page_size_(std::max<size_t>(page_size, 1)) {
     }
 
-    auto begin() const {
-        return pages_.begin();
+    PageIterator begin() const {
+        return {begin_, end_, page_size_};
     }
 
-    auto end() const {
-        return pages_.end();
+    PageIterator end() const {
+        return {end_, end_, page_size_};
     }
 
+    //O(1) для итераторов произвольного доступа, иначе требует прохода по диапазону
     size_t size() const {
-        return pages_.size();
+        const size_t items = std::distance(begin_, end_);
+        return (items + page_size_ - 1) / page_size_;
+    }
+
+    IteratorRange<Iterator> GetPage(size_t index) const {
+        Iterator page_begin = begin_;
+        if constexpr (IS_RANDOM_ACCESS_ITERATOR<Iterator>) {
+            AdvanceBounded(page_begin, index * page_size_, end_);
+        } else {
+            for (size_t i = 0; i < index && page_begin != end_; ++i) {
+                AdvanceBounded(page_begin, page_size_, end_);
+            }
+        }
+        return *PageIterator(page_begin, end_, page_size_);
+    }
+
+    IteratorRange<Iterator> operator[](size_t index) const {
+        return GetPage(index);
     }
 
 private:
-    std::vector<IteratorRange<Iterator>> pages_;
+    Iterator begin_, end_;
+    size_t page_size_;
 };
 
 template <typename Container>
 auto Paginate(const Container& c, size_t page_size) {
-    return Paginator(begin(c), end(c), page_size);
+    return Paginator(std::begin(c), std::end(c), page_size);
+}
+
+//Постраничный обход потокового источника, который нельзя пройти повторно.
+//Source должен предоставлять метод NextPage(page_size), возвращающий очередную страницу
+//(пустую, когда источник исчерпан); следующая страница запрашивается только при переходе к ней
+template <typename Source>
+class StreamPaginator {
+public:
+    using Page = decltype(std::declval<Source&>().NextPage(size_t{}));
+
+    class PageIterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Page;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Page*;
+        using reference = const Page&;
+
+        PageIterator() = default;
+
+        PageIterator(Source* source, size_t page_size)
+                : source_(source)
+                , page_size_(page_size) {
+            Fetch();
+        }
+
+        const Page& operator*() const {
+            return page_;
+        }
+
+        const Page* operator->() const {
+            return &page_;
+        }
+
+        PageIterator& operator++() {
+            Fetch();
+            return *this;
+        }
+
+        bool operator==(const PageIterator& rhs) const {
+            return source_ == rhs.source_;
+        }
+
+        bool operator!=(const PageIterator& rhs) const {
+            return !(*this == rhs);
+        }
+
+    private:
+        Source* source_ = nullptr;
+        size_t page_size_ = 0;
+        Page page_;
+
+        void Fetch() {
+            page_ = source_->NextPage(page_size_);
+            if (page_.empty()) {
+                source_ = nullptr;
+            }
+        }
+    };
+
+    StreamPaginator(Source& source, size_t page_size)
+            : source_(source)
+            , page_size_(std::max<size_t>(page_size, 1)) {
+    }
+
+    //обход расходует источник, поэтому begin() можно вызвать один раз
+    PageIterator begin() const {
+        return {&source_, page_size_};
+    }
+
+    PageIterator end() const {
+        return {};
+    }
+
+private:
+    Source& source_;
+    size_t page_size_;
+};
+
+template <typename Source>
+auto PaginateStream(Source& source, size_t page_size) {
+    return StreamPaginator<Source>(source, page_size);
 }
\ No newline at end of file
@@ -0,0 +1,263 @@
+#include "profiler.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+using namespace std;
+
+atomic<bool> Profiler::enabled_ = false;
+
+namespace {
+
+const ProfileScope::Clock::time_point PROFILER_EPOCH = ProfileScope::Clock::now();
+
+//Дерево путей общее для всех потоков; узел 0 - корень.
+//Потоки обращаются к нему только при первой встрече пары (родитель, имя)
+struct PathRegistry {
+    mutex guard;
+    vector<pair<uint32_t, const char*>> nodes{ { 0, "" } };
+    map<pair<uint32_t, const char*>, uint32_t> ids;
+
+    uint32_t Intern(uint32_t parent, const char* name) {
+        lock_guard lock(guard);
+        const auto [it, inserted] = ids.emplace(make_pair(parent, name), static_cast<uint32_t>(nodes.size()));
+        if (inserted) {
+            nodes.emplace_back(parent, name);
+        }
+        return it->second;
+    }
+};
+
+PathRegistry& GetPathRegistry() {
+    static PathRegistry registry;
+    return registry;
+}
+
+//Буфер событий потока. Мьютекс захватывает только сам поток и Flush, поэтому он почти всегда свободен
+struct ThreadBuffer {
+    mutex guard;
+    vector<ProfileEvent> events;
+    uint64_t dropped_event_count = 0;
+};
+
+//buffers[thread_id] - буфер потока; free_ids - буферы завершившихся потоков, которые займут новые потоки
+struct BufferRegistry {
+    mutex guard;
+    vector<shared_ptr<ThreadBuffer>> buffers;
+    vector<uint32_t> free_ids;
+};
+
+BufferRegistry& GetBufferRegistry() {
+    static BufferRegistry registry;
+    return registry;
+}
+
+struct PairHash {
+    size_t operator()(const pair<uint32_t, const char*>& key) const {
+        return hash<const char*>{}(key.second) ^ (static_cast<size_t>(key.first) * 0x9e3779b97f4a7c15ULL);
+    }
+};
+
+struct ThreadState {
+    uint32_t thread_id = 0;
+    shared_ptr<ThreadBuffer> buffer;
+    vector<uint32_t> path_stack{ 0 };
+    unordered_map<pair<uint32_t, const char*>, uint32_t, PairHash> path_cache;
+
+    ThreadState() {
+        BufferRegistry& registry = GetBufferRegistry();
+        lock_guard lock(registry.guard);
+        if (!registry.free_ids.empty()) {
+            thread_id = registry.free_ids.back();
+            registry.free_ids.pop_back();
+            buffer = registry.buffers[thread_id];
+        } else {
+            thread_id = static_cast<uint32_t>(registry.buffers.size());
+            buffer = make_shared<ThreadBuffer>();
+            registry.buffers.push_back(buffer);
+        }
+    }
+
+    //события потока остаются в буфере до Flush
+    ~ThreadState() {
+        BufferRegistry& registry = GetBufferRegistry();
+        lock_guard lock(registry.guard);
+        registry.free_ids.push_back(thread_id);
+    }
+
+    ThreadState(const ThreadState&) = delete;
+    ThreadState& operator=(const ThreadState&) = delete;
+
+    uint32_t GetPathId(uint32_t parent, const char* name) {
+        const auto key = make_pair(parent, name);
+        const auto it = path_cache.find(key);
+        if (it != path_cache.end()) {
+            return it->second;
+        }
+        const uint32_t id = GetPathRegistry().Intern(parent, name);
+        path_cache.emplace(key, id);
+        return id;
+    }
+};
+
+ThreadState& GetThreadState() {
+    thread_local ThreadState state;
+    return state;
+}
+
+int64_t ToNanoseconds(ProfileScope::Clock::time_point time) {
+    return chrono::duration_cast<chrono::nanoseconds>(time - PROFILER_EPOCH).count();
+}
+
+void WriteJsonString(ostream& out, string_view text) {
+    out << '"';
+    for (const char c : text) {
+        if (c == '"' || c == '\\') {
+            out << '\\';
+        }
+        out << c;
+    }
+    out << '"';
+}
+
+}
+
+ProfileScope::ProfileScope(const char* name) {
+    if (!Profiler::IsEnabled()) {
+        return;
+    }
+    ThreadState& state = GetThreadState();
+    path_id_ = state.GetPathId(state.path_stack.back(), name);
+    state.path_stack.push_back(path_id_);
+    active_ = true;
+    start_time_ = Clock::now();
+}
+
+ProfileScope::~ProfileScope() {
+    if (!active_) {
+        return;
+    }
+    const auto end_time = Clock::now();
+    ThreadState& state = GetThreadState();
+    state.path_stack.pop_back();
+    ThreadBuffer& buffer = *state.buffer;
+    lock_guard lock(buffer.guard);
+    if (buffer.events.size() >= Profiler::MAX_BUFFERED_EVENTS) {
+        ++buffer.dropped_event_count;
+        return;
+    }
+    buffer.events.push_back({ path_id_, state.thread_id, ToNanoseconds(start_time_), ToNanoseconds(end_time) });
+}
+
+void Profiler::Enable(bool enabled) {
+    enabled_.store(enabled, memory_order_relaxed);
+}
+
+ProfileReport Profiler::Flush() {
+    vector<ProfileEvent> events;
+    uint64_t dropped_event_count = 0;
+    {
+        BufferRegistry& registry = GetBufferRegistry();
+        lock_guard lock(registry.guard);
+        for (const auto& buffer : registry.buffers) {
+            vector<ProfileEvent> buffer_events;
+            {
+                lock_guard buffer_lock(buffer->guard);
+                buffer_events.swap(buffer->events);
+                dropped_event_count += exchange(buffer->dropped_event_count, 0);
+            }
+            events.insert(events.end(), buffer_events.begin(), buffer_events.end());
+        }
+    }
+
+    vector<string> paths;
+    vector<const char*> names;
+    {
+        PathRegistry& registry = GetPathRegistry();
+        lock_guard lock(registry.guard);
+        paths.reserve(registry.nodes.size());
+        for (const auto& [parent, name] : registry.nodes) {
+            //родитель всегда создаётся раньше потомка
+            paths.push_back(paths.empty() || parent == 0 ? string(name) : paths[parent] + "/" + name);
+            names.push_back(name);
+        }
+    }
+    return { move(events), move(paths), move(names), dropped_event_count };
+}
+
+ProfileReport::ProfileReport(vector<ProfileEvent> events, vector<string> paths, vector<const char*> names,
+                             uint64_t dropped_event_count)
+    : events_(move(events))
+    , paths_(move(paths))
+    , names_(move(names))
+    , dropped_event_count_(dropped_event_count)
+{
+}
+
+void ProfileReport::WriteChromeTrace(ostream& out) const {
+    const auto flags = out.flags();
+    const auto precision = out.precision();
+    out << fixed << setprecision(3) << "{\"traceEvents\":["s;
+    bool first = true;
+    for (const ProfileEvent& event : events_) {
+        if (!first) {
+            out << ',';
+        }
+        first = false;
+        out << "{\"name\":"s;
+        WriteJsonString(out, names_[event.path_id]);
+        out << ",\"cat\":\"search\",\"ph\":\"X\",\"pid\":0,\"tid\":"s << event.thread_id
+            << ",\"ts\":"s << event.start_ns / 1000.0
+            << ",\"dur\":"s << (event.end_ns - event.start_ns) / 1000.0
+            << ",\"args\":{\"path\":"s;
+        WriteJsonString(out, paths_[event.path_id]);
+        out << "}}"s;
+    }
+    out << "],\"otherData\":{\"dropped_events\":"s << dropped_event_count_ << "}}"s << endl;
+    out.flags(flags);
+    out.precision(precision);
+}
+
+vector<ProfileScopeStats> ProfileReport::Aggregate() const {
+    //одинаковые литералы из разных единиц трансляции могут иметь разные адреса, поэтому группировка по тексту пути
+    map<string_view, vector<int64_t>> durations;
+    for (const ProfileEvent& event : events_) {
+        durations[paths_[event.path_id]].push_back(event.end_ns - event.start_ns);
+    }
+
+    vector<ProfileScopeStats> result;
+    for (auto& [path, values] : durations) {
+        sort(values.begin(), values.end());
+        const auto percentile = [&values = values](size_t percent) {
+            return chrono::nanoseconds(values[(values.size() - 1) * percent / 100]);
+        };
+        ProfileScopeStats stats;
+        stats.path = string(path);
+        stats.count = values.size();
+        for (const int64_t value : values) {
+            stats.total += chrono::nanoseconds(value);
+        }
+        stats.p50 = percentile(50);
+        stats.p90 = percentile(90);
+        stats.p99 = percentile(99);
+        stats.max = chrono::nanoseconds(values.back());
+        result.push_back(move(stats));
+    }
+    sort(result.begin(), result.end(), [](const ProfileScopeStats& lhs, const ProfileScopeStats& rhs) {
+        return lhs.total > rhs.total;
+    });
+    return result;
+}
+
+const vector<ProfileEvent>& ProfileReport::GetEvents() const {
+    return events_;
+}
+
+uint64_t ProfileReport::GetDroppedEventCount() const {
+    return dropped_event_count_;
+}
\ No newline at end of file
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "log_duration.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+//Иерархический профилировщик областей видимости с той же эргономикой, что и LOG_DURATION.
+//Область открывается макросом PROFILE_SCOPE("имя"), имя должно быть строковым литералом.
+//На горячем пути только берутся отметки времени steady_clock в наносекундах и событие
+//добавляется в буфер своего потока; вывод и агрегация выполняются позже, в Profiler::Flush().
+//Вложенные области образуют дерево путей вида "FindTopDocuments/FindAllDocuments".
+//По умолчанию профилировщик выключен (стоимость области - одна атомарная загрузка),
+//при SEARCH_SERVER_DISABLE_PROFILER макрос не генерирует кода.
+//Буфер завершившегося потока переходит к следующему новому потоку (с тем же thread_id в отчёте),
+//поэтому число буферов ограничено числом одновременно живущих потоков. Между вызовами Flush буфер
+//хранит не больше MAX_BUFFERED_EVENTS событий, следующие отбрасываются и учитываются в отчёте
+
+#ifdef SEARCH_SERVER_DISABLE_PROFILER
+#define PROFILE_SCOPE(x)
+#else
+#define PROFILE_SCOPE(x) ProfileScope UNIQUE_VAR_NAME_PROFILE(x)
+#endif
+
+//Событие завершённой области: path_id - идентификатор пути в дереве областей
+struct ProfileEvent {
+    uint32_t path_id = 0;
+    uint32_t thread_id = 0;
+    int64_t start_ns = 0;
+    int64_t end_ns = 0;
+};
+
+//Сводка по одному пути дерева областей
+struct ProfileScopeStats {
+    std::string path;
+    size_t count = 0;
+    std::chrono::nanoseconds total{};
+    std::chrono::nanoseconds p50{};
+    std::chrono::nanoseconds p90{};
+    std::chrono::nanoseconds p99{};
+    std::chrono::nanoseconds max{};
+};
+
+//События, собранные одним вызовом Profiler::Flush()
+class ProfileReport {
+public:
+    ProfileReport(std::vector<ProfileEvent> events, std::vector<std::string> paths, std::vector<const char*> names,
+                  uint64_t dropped_event_count = 0);
+
+    //формат Chrome trace (chrome://tracing, Perfetto): события "X" с временем в микросекундах
+    void WriteChromeTrace(std::ostream& out) const;
+
+    //сводка по путям в порядке убывания суммарного времени
+    [[nodiscard]] std::vector<ProfileScopeStats> Aggregate() const;
+
+    [[nodiscard]] const std::vector<ProfileEvent>& GetEvents() const;
+
+    //события, не попавшие в отчёт из-за переполнения буферов потоков
+    [[nodiscard]] uint64_t GetDroppedEventCount() const;
+
+private:
+    std::vector<ProfileEvent> events_;
+    std::vector<std::string> paths_;
+    std::vector<const char*> names_;
+    uint64_t dropped_event_count_ = 0;
+};
+
+class Profiler {
+public:
+    //предел событий в буфере одного потока между вызовами Flush
+    static constexpr size_t MAX_BUFFERED_EVENTS = size_t{ 1 } << 18;
+
+    static void Enable(bool enabled = true);
+    static bool IsEnabled() {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    //забирает накопленные события из буферов всех потоков
+    static ProfileReport Flush();
+
+private:
+    static std::atomic<bool> enabled_;
+};
+
+class ProfileScope {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit ProfileScope(const char* name);
+    ~ProfileScope();
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    uint32_t path_id_ = 0;
+    bool active_ = false;
+    Clock::time_point start_time_;
+};
\ No newline at end of file
@@ -0,0 +1,119 @@
+#include "query_arena.h"
+
+#include <algorithm>
+#include <new>
+
+using namespace std;
+
+QueryArena::QueryArena(size_t initial_block_size)
+    : initial_block_size_(max(initial_block_size, BLOCK_ALIGNMENT))
+{
+}
+
+QueryArena::~QueryArena() {
+    Block* block = current_.load(memory_order_relaxed);
+    while (block != nullptr) {
+        Block* prev = block->prev;
+        FreeBlock(block);
+        block = prev;
+    }
+}
+
+void QueryArena::Reset() {
+    Block* block = current_.load(memory_order_relaxed);
+    if (block == nullptr) {
+        return;
+    }
+    Block* prev = block->prev;
+    while (prev != nullptr) {
+        Block* next_prev = prev->prev;
+        FreeBlock(prev);
+        prev = next_prev;
+    }
+    block->prev = nullptr;
+    block->used.store(0, memory_order_relaxed);
+}
+
+size_t QueryArena::GetCapacity() const {
+    size_t capacity = 0;
+    for (const Block* block = current_.load(memory_order_acquire); block != nullptr; block = block->prev) {
+        capacity += block->size;
+    }
+    return capacity;
+}
+
+void* QueryArena::do_allocate(size_t bytes, size_t alignment) {
+    //размер кратен BLOCK_ALIGNMENT, поэтому каждое выделение начинается с выровненного адреса;
+    //для большего выравнивания резервируется запас
+    const size_t extra = alignment > BLOCK_ALIGNMENT ? alignment - BLOCK_ALIGNMENT : 0;
+    const size_t size = (bytes + extra + BLOCK_ALIGNMENT - 1) / BLOCK_ALIGNMENT * BLOCK_ALIGNMENT;
+    while (true) {
+        Block* block = current_.load(memory_order_acquire);
+        if (block != nullptr) {
+            const size_t offset = block->used.fetch_add(size, memory_order_relaxed);
+            if (offset + size <= block->size) {
+                void* data = reinterpret_cast<char*>(block + 1) + offset;
+                size_t space = size;
+                return align(alignment, bytes, data, space);
+            }
+        }
+        Grow(block, size);
+    }
+}
+
+void QueryArena::do_deallocate(void*, size_t, size_t) {
+}
+
+bool QueryArena::do_is_equal(const pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+void QueryArena::Grow(Block* full_block, size_t min_size) {
+    lock_guard guard(grow_mutex_);
+    if (current_.load(memory_order_relaxed) != full_block) {
+        return;
+    }
+    const size_t size = max(full_block == nullptr ? initial_block_size_ : full_block->size * 2, min_size);
+    Block* block = new (::operator new(sizeof(Block) + size)) Block;
+    block->prev = full_block;
+    block->size = size;
+    current_.store(block, memory_order_release);
+}
+
+void QueryArena::FreeBlock(Block* block) {
+    block->~Block();
+    ::operator delete(block);
+}
+
+namespace {
+
+struct ThreadArena {
+    QueryArena arena;
+    int depth = 0;
+};
+
+ThreadArena& GetThreadArena() {
+    thread_local ThreadArena thread_arena;
+    return thread_arena;
+}
+
+}
+
+QueryArenaScope::QueryArenaScope() {
+    ++GetThreadArena().depth;
+}
+
+QueryArenaScope::~QueryArenaScope() {
+    ThreadArena& thread_arena = GetThreadArena();
+    if (--thread_arena.depth == 0) {
+        thread_arena.arena.Reset();
+    }
+}
+
+pmr::memory_resource* QueryArenaScope::GetResource() {
+    ThreadArena& thread_arena = GetThreadArena();
+    if (thread_arena.depth > 0) {
+        return &thread_arena.arena;
+    }
+    return pmr::get_default_resource();
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
+
+//Монотонная арена для временных структур одного запроса (множества слов запроса,
+//карта релевантности, промежуточная выдача). Выделение - атомарный сдвиг указателя
+//в текущем блоке, освобождение отдельных объектов ничего не делает.
+//Выделять память можно из нескольких потоков одновременно (параллельный FindAllDocuments),
+//Reset() - только когда памятью арены никто не пользуется
+class QueryArena final : public std::pmr::memory_resource {
+public:
+    explicit QueryArena(size_t initial_block_size = 64 * 1024);
+    ~QueryArena() override;
+
+    QueryArena(const QueryArena&) = delete;
+    QueryArena& operator=(const QueryArena&) = delete;
+
+    //освобождает всё выделенное, кроме последнего (наибольшего) блока,
+    //поэтому после первых запросов арена больше не обращается к malloc
+    void Reset();
+
+    //суммарный размер блоков арены в байтах
+    [[nodiscard]] size_t GetCapacity() const;
+
+private:
+    static constexpr size_t BLOCK_ALIGNMENT = alignof(std::max_align_t);
+
+    struct alignas(BLOCK_ALIGNMENT) Block {
+        Block* prev = nullptr;
+        size_t size = 0;
+        std::atomic<size_t> used{ 0 };
+    };
+
+    std::atomic<Block*> current_{ nullptr };
+    std::mutex grow_mutex_;
+    const size_t initial_block_size_;
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    //добавляет блок, если full_block всё ещё текущий
+    void Grow(Block* full_block, size_t min_size);
+    static void FreeBlock(Block* block);
+};
+
+//Область запроса. Внешняя область в потоке делает арену этого потока текущей,
+//при выходе из неё арена очищается. Вложенные области (запрос, выполняемый в потоке
+//во время ожидания другого) пользуются той же ареной и её не очищают
+class QueryArenaScope {
+public:
+    QueryArenaScope();
+    ~QueryArenaScope();
+
+    QueryArenaScope(const QueryArenaScope&) = delete;
+    QueryArenaScope& operator=(const QueryArenaScope&) = delete;
+
+    //арена потока внутри области, вне области - ресурс по умолчанию (new/delete)
+    static std::pmr::memory_resource* GetResource();
+};
\ No newline at end of file
@@ -0,0 +1,70 @@
+#include "query_cache.h"
+
+#include <algorithm>
+#include <functional>
+
+using namespace std;
+
+QueryCache::QueryCache(const SearchServer& search_server, size_t capacity, size_t shard_count)
+    : search_server_(search_server)
+    , shard_capacity_(max<size_t>(capacity / max<size_t>(shard_count, 1), 1))
+    , shards_(max<size_t>(shard_count, 1))
+{
+}
+
+vector<Document> QueryCache::FindTopDocuments(string_view raw_query, DocumentStatus status) {
+    string key = search_server_.NormalizeQuery(raw_query);
+    key.push_back('\t');
+    key.push_back(static_cast<char>('0' + static_cast<int>(status)));
+
+    const uint64_t index_version = search_server_.GetIndexVersion();
+    Shard& shard = shards_[hash<string>{}(key) % shards_.size()];
+    {
+        lock_guard guard(shard.guard);
+        const auto it = shard.index.find(key);
+        if (it != shard.index.end() && it->second->index_version == index_version) {
+            shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+            hits_.fetch_add(1, memory_order_relaxed);
+            return it->second->documents;
+        }
+    }
+
+    //поиск выполняется без блокировки сегмента, чтобы не задерживать другие запросы к нему
+    misses_.fetch_add(1, memory_order_relaxed);
+    vector<Document> documents = search_server_.FindTopDocuments(raw_query, status);
+    Store(shard, move(key), index_version, documents);
+    return documents;
+}
+
+vector<Document> QueryCache::FindTopDocuments(string_view raw_query) {
+    return FindTopDocuments(raw_query, DocumentStatus::ACTUAL);
+}
+
+const SearchServer& QueryCache::GetSearchServer() const {
+    return search_server_;
+}
+
+uint64_t QueryCache::GetHits() const {
+    return hits_.load(memory_order_relaxed);
+}
+
+uint64_t QueryCache::GetMisses() const {
+    return misses_.load(memory_order_relaxed);
+}
+
+void QueryCache::Store(Shard& shard, string key, uint64_t index_version, const vector<Document>& documents) {
+    lock_guard guard(shard.guard);
+    const auto it = shard.index.find(key);
+    if (it != shard.index.end()) {
+        it->second->index_version = index_version;
+        it->second->documents = documents;
+        shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+        return;
+    }
+    if (shard.entries.size() >= shard_capacity_) {
+        shard.index.erase(shard.entries.back().key);
+        shard.entries.pop_back();
+    }
+    shard.entries.push_front({ move(key), index_version, documents });
+    shard.index.emplace(shard.entries.front().key, shard.entries.begin());
+}
\ No newline at end of file
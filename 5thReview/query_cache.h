@@ -0,0 +1,52 @@
+#pragma once
+
+#include "document.h"
+#include "search_server.h"
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+//Кеш результатов FindTopDocuments, разбитый на независимые LRU-сегменты со своими мьютексами.
+//Ключ - каноническая запись запроса (SearchServer::NormalizeQuery) и статус документов,
+//поэтому "cat -dog" и "-dog cat cat" попадают в одну запись. Запись считается устаревшей,
+//если версия индекса изменилась после её вычисления. Запросы с произвольным предикатом
+//не кешируются: у лямбды нет идентичности, по которой можно построить ключ
+
+class QueryCache {
+public:
+    explicit QueryCache(const SearchServer& search_server, size_t capacity = 10'000, size_t shard_count = 16);
+
+    std::vector<Document> FindTopDocuments(std::string_view raw_query, DocumentStatus status);
+    std::vector<Document> FindTopDocuments(std::string_view raw_query);
+
+    [[nodiscard]] const SearchServer& GetSearchServer() const;
+    [[nodiscard]] uint64_t GetHits() const;
+    [[nodiscard]] uint64_t GetMisses() const;
+
+private:
+    struct Entry {
+        std::string key;
+        uint64_t index_version = 0;
+        std::vector<Document> documents;
+    };
+
+    //в начале списка - самые недавно использованные записи
+    struct Shard {
+        std::mutex guard;
+        std::list<Entry> entries;
+        std::unordered_map<std::string_view, std::list<Entry>::iterator> index;
+    };
+
+    const SearchServer& search_server_;
+    const size_t shard_capacity_;
+    std::vector<Shard> shards_;
+    std::atomic<uint64_t> hits_ = 0;
+    std::atomic<uint64_t> misses_ = 0;
+
+    void Store(Shard& shard, std::string key, uint64_t index_version, const std::vector<Document>& documents);
+};
\ No newline at end of file
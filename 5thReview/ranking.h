@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+
+//Функции ранжирования для FindTopDocuments. Политика передаётся параметром шаблона,
+//поэтому внутренний цикл по спискам документов обходится без виртуальных вызовов.
+//Политика должна предоставлять:
+//  ComputeInverseDocumentFreq(document_count, document_freq) - вес слова, считается один раз на слово запроса;
+//  ComputeTermScore(term_freq, document_length, average_document_length) - вклад вхождения слова в документ,
+//  умножается на вес слова. term_freq - доля слова среди слов документа, document_length - число слов документа
+//  без стоп-слов. Длины документов и их среднее поддерживаются индексом при добавлении и удалении;
+//  USES_DOCUMENT_LENGTH - нужна ли длина документа (если нет, фильтр по статусу обходится без поиска документа)
+
+//TF-IDF: tf * log(N / df)
+struct TfIdfRanking {
+    static constexpr bool USES_DOCUMENT_LENGTH = false;
+
+    [[nodiscard]] double ComputeInverseDocumentFreq(int document_count, size_t document_freq) const {
+        return std::log(document_count * 1.0 / document_freq);
+    }
+    [[nodiscard]] double ComputeTermScore(double term_freq, int /*document_length*/, double /*average_document_length*/) const {
+        return term_freq;
+    }
+};
+
+//Okapi BM25: idf * f * (k1 + 1) / (f + k1 * (1 - b + b * dl / avgdl)), где f - число вхождений слова в документ
+struct Bm25Ranking {
+    static constexpr bool USES_DOCUMENT_LENGTH = true;
+
+    double k1 = 1.2;
+    double b = 0.75;
+
+    [[nodiscard]] double ComputeInverseDocumentFreq(int document_count, size_t document_freq) const {
+        const double freq = static_cast<double>(document_freq);
+        return std::log((document_count - freq + 0.5) / (freq + 0.5) + 1.0);
+    }
+    [[nodiscard]] double ComputeTermScore(double term_freq, int document_length, double average_document_length) const {
+        const double count = term_freq * document_length;
+        const double length_norm = k1 * (1.0 - b + b * document_length / average_document_length);
+        return count * (k1 + 1.0) / (count + length_norm);
+    }
+};
\ No newline at end of file
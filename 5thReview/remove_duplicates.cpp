@@ -1,26 +1,183 @@
 #include "remove_duplicates.h"
 
-#include <iostream>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <execution>
+#include <functional>
+#include <limits>
 #include <map>
-#include <set>
-#include <string>
+#include <numeric>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
-void RemoveDuplicates(SearchServer& search_server){
-    std::set<std::set<std::string>> docs;
-    std::vector<int> ids_to_remove;
-    for (int document_id : search_server) {
-        std::set<std::string> keys;
-        for (const auto& [word, freq] : search_server.GetWordFrequencies(document_id))
-        {
-            keys.insert(word);
+namespace {
+
+//Финализатор splitmix64: перемешивает биты 64-битного значения
+uint64_t Mix64(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+//Слова хранятся в SearchServer в единственном экземпляре,
+//поэтому адрес строки слова служит его идентификатором и сами строки не хешируются
+uint64_t ComputeFingerprint(const SearchServer::WordFrequencies& word_freqs) {
+    uint64_t hash = Mix64(word_freqs.size());
+    for (const auto& [word, freq] : word_freqs) {
+        hash = Mix64(hash ^ Mix64(reinterpret_cast<uintptr_t>(word.data())));
+    }
+    return hash;
+}
+
+bool HasSameWords(const SearchServer::WordFrequencies& lhs, const SearchServer::WordFrequencies& rhs) {
+    return lhs.size() == rhs.size()
+           && std::equal(lhs.begin(), lhs.end(), rhs.begin(),
+                         [](const auto& l, const auto& r) { return l.first.data() == r.first.data(); });
+}
+
+constexpr size_t MIN_HASH_SIZE = 128;
+using MinHashSignature = std::array<uint64_t, MIN_HASH_SIZE>;
+
+//В отличие от точного поиска слова хешируются по содержимому,
+//чтобы подписи не зависели от адресов строк
+MinHashSignature ComputeMinHashSignature(const SearchServer::WordFrequencies& word_freqs) {
+    MinHashSignature signature;
+    signature.fill(std::numeric_limits<uint64_t>::max());
+    for (const auto& [word, freq] : word_freqs) {
+        const uint64_t word_hash = std::hash<std::string_view>{}(word);
+        for (size_t i = 0; i < MIN_HASH_SIZE; ++i) {
+            signature[i] = std::min(signature[i], Mix64(word_hash ^ Mix64(i)));
         }
-        if (!docs.insert(keys).second) {
-            ids_to_remove.push_back(document_id);
+    }
+    return signature;
+}
+
+double ComputeJaccardSimilarity(const SearchServer::WordFrequencies& lhs, const SearchServer::WordFrequencies& rhs) {
+    if (lhs.empty() && rhs.empty()) {
+        return 1.0;
+    }
+    size_t common = 0;
+    for (auto l = lhs.begin(), r = rhs.begin(); l != lhs.end() && r != rhs.end();) {
+        if (l->first < r->first) {
+            ++l;
+        } else if (r->first < l->first) {
+            ++r;
+        } else {
+            ++common, ++l, ++r;
+        }
+    }
+    return static_cast<double>(common) / static_cast<double>(lhs.size() + rhs.size() - common);
+}
+
+//Подбирает число строк в полосе так, чтобы порог срабатывания LSH (1/b)^(1/r)
+//был не выше заданного: лишние кандидаты отсеиваются точной проверкой, пропуски не исправляются
+size_t ComputeRowsPerBand(double similarity_threshold) {
+    size_t rows = 1;
+    for (size_t r = 2; r <= MIN_HASH_SIZE; ++r) {
+        const double bands = static_cast<double>(MIN_HASH_SIZE / r);
+        if (std::pow(1.0 / bands, 1.0 / static_cast<double>(r)) > similarity_threshold) {
+            break;
+        }
+        rows = r;
+    }
+    return rows;
+}
+
+}
+
+std::vector<int> RemoveDuplicates(SearchServer& search_server) {
+    const std::vector<int> document_ids(search_server.begin(), search_server.end());
+
+    std::vector<uint64_t> fingerprints(document_ids.size());
+    std::transform(std::execution::par,
+                   document_ids.begin(), document_ids.end(),
+                   fingerprints.begin(),
+                   [&search_server](int document_id) {
+                       return ComputeFingerprint(search_server.GetWordFrequencies(document_id));
+                   });
+
+    //совпадение отпечатков перепроверяется сравнением слов, коллизии не приводят к ложному удалению
+    std::unordered_multimap<uint64_t, int> originals;
+    originals.reserve(document_ids.size());
+    std::vector<int> ids_to_remove;
+    for (size_t i = 0; i < document_ids.size(); ++i) {
+        const auto& words = search_server.GetWordFrequencies(document_ids[i]);
+        const auto [first, last] = originals.equal_range(fingerprints[i]);
+        const bool is_duplicate = std::any_of(first, last, [&search_server, &words](const auto& original) {
+            return HasSameWords(search_server.GetWordFrequencies(original.second), words);
+        });
+        if (is_duplicate) {
+            ids_to_remove.push_back(document_ids[i]);
+        } else {
+            originals.emplace(fingerprints[i], document_ids[i]);
         }
     }
-    for (auto id : ids_to_remove) {
-        std::cout << "Found duplicate document id " << id << std::endl;
-        search_server.RemoveDocument(id);
+
+    search_server.RemoveDocuments(ids_to_remove);
+    return ids_to_remove;
+}
+
+std::vector<int> RemoveNearDuplicates(SearchServer& search_server, double similarity_threshold) {
+    if (!(similarity_threshold > 0.0 && similarity_threshold <= 1.0)) {
+        throw std::invalid_argument("Similarity threshold must be in (0, 1]");
     }
+    const std::vector<int> document_ids(search_server.begin(), search_server.end());
+    const size_t rows = ComputeRowsPerBand(similarity_threshold);
+    const size_t bands = MIN_HASH_SIZE / rows;
+
+    //ключи полос всех документов: band_keys[i * bands + band]
+    std::vector<uint64_t> band_keys(document_ids.size() * bands);
+    std::vector<size_t> indexes(document_ids.size());
+    std::iota(indexes.begin(), indexes.end(), 0);
+    std::for_each(std::execution::par,
+                  indexes.begin(), indexes.end(),
+                  [&search_server, &document_ids, &band_keys, rows, bands](size_t i) {
+                      const MinHashSignature signature = ComputeMinHashSignature(search_server.GetWordFrequencies(document_ids[i]));
+                      for (size_t band = 0; band < bands; ++band) {
+                          uint64_t key = Mix64(band);
+                          for (size_t row = band * rows; row < (band + 1) * rows; ++row) {
+                              key = Mix64(key ^ signature[row]);
+                          }
+                          band_keys[i * bands + band] = key;
+                      }
+                  });
+
+    //в корзинах лежат только оставленные документы, каждый удаляемый сравнивается с ними
+    std::unordered_map<uint64_t, std::vector<size_t>> buckets;
+    buckets.reserve(document_ids.size() * bands);
+    std::vector<size_t> candidates;
+    std::vector<int> ids_to_remove;
+    for (size_t i = 0; i < document_ids.size(); ++i) {
+        candidates.clear();
+        for (size_t band = 0; band < bands; ++band) {
+            const auto it = buckets.find(band_keys[i * bands + band]);
+            if (it != buckets.end()) {
+                candidates.insert(candidates.end(), it->second.begin(), it->second.end());
+            }
+        }
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+        const auto& words = search_server.GetWordFrequencies(document_ids[i]);
+        const bool is_duplicate = std::any_of(candidates.begin(), candidates.end(),
+                                              [&](size_t candidate) {
+                                                  return ComputeJaccardSimilarity(search_server.GetWordFrequencies(document_ids[candidate]), words)
+                                                         >= similarity_threshold;
+                                              });
+        if (is_duplicate) {
+            ids_to_remove.push_back(document_ids[i]);
+        } else {
+            for (size_t band = 0; band < bands; ++band) {
+                buckets[band_keys[i * bands + band]].push_back(i);
+            }
+        }
+    }
+
+    search_server.RemoveDocuments(ids_to_remove);
+    return ids_to_remove;
 }
\ No newline at end of file
@@ -1,4 +1,13 @@
 #pragma once
 #include "search_server.h"
 
-void RemoveDuplicates(SearchServer& search_server);
\ No newline at end of file
+#include <vector>
+
+//Удаляет документы с совпадающими множествами слов, оставляя документ с наименьшим id.
+//Возвращает id удалённых документов
+std::vector<int> RemoveDuplicates(SearchServer& search_server);
+
+//Удаляет почти-дубликаты: документ удаляется, если коэффициент Жаккара его множества слов
+//с одним из ранее оставленных документов не меньше similarity_threshold (0 < threshold <= 1).
+//Кандидаты ищутся через MinHash LSH, поэтому время работы близко к линейному
+std::vector<int> RemoveNearDuplicates(SearchServer& search_server, double similarity_threshold);
\ No newline at end of file
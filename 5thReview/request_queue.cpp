@@ -1,31 +1,182 @@
 #include "request_queue.h"
 
+#include <algorithm>
+#include <cassert>
+#include <thread>
+
+using namespace std;
+
+RequestQueue::RequestQueue(const SearchServer& search_server, chrono::nanoseconds window)
+    : search_server_(search_server)
+    , start_time_(Clock::now())
+    , slot_duration_(max(window / SLOT_COUNT, chrono::nanoseconds(1)))
+    , slots_(SLOT_COUNT)
+{
+}
+
+RequestQueue::RequestQueue(QueryCache& query_cache, chrono::nanoseconds window)
+    : RequestQueue(query_cache.GetSearchServer(), window)
+{
+    query_cache_ = &query_cache;
+}
+
 //Реализация методов AddFindRequest
-std::vector<Document> RequestQueue::AddFindRequest(const std::string& raw_query, DocumentStatus status) {
-    const std::vector<Document> result = search_server_.FindTopDocuments(raw_query, status);
-    AddRequest(result.size());
+vector<Document> RequestQueue::AddFindRequest(const string& raw_query, DocumentStatus status) {
+    const auto start_time = Clock::now();
+    const vector<Document> result = query_cache_ != nullptr
+                                    ? query_cache_->FindTopDocuments(raw_query, status)
+                                    : search_server_.FindTopDocuments(raw_query, status);
+    AddRequest(result.size(), start_time);
     return result;
 }
-std::vector<Document> RequestQueue::AddFindRequest(const std::string& raw_query) {
-    const std::vector<Document> result = search_server_.FindTopDocuments(raw_query);
-    AddRequest(result.size());
-    return result;
+vector<Document> RequestQueue::AddFindRequest(const string& raw_query) {
+    return AddFindRequest(raw_query, DocumentStatus::ACTUAL);
 }
 
 int RequestQueue::GetNoResultRequests() const {
-    return no_results_requests_;
+    return static_cast<int>(GetStats().no_result_requests);
 }
 
-void RequestQueue::AddRequest(int results_num) {
-    ++current_time_;
-    while (!requests_.empty() && sec_in_day_ <= current_time_ - requests_.front().timestamp) {
-        if (0 == requests_.front().results) {
-            --no_results_requests_;
+RequestStats RequestQueue::GetStats() const {
+    const auto now = Clock::now();
+    const uint64_t current_epoch = GetEpoch(now);
+
+    RequestStats stats;
+    array<uint64_t, LATENCY_BUCKET_COUNT> latency{};
+    for (const Slot& slot : slots_) {
+        const uint64_t state = slot.state.load(memory_order_acquire);
+        //слот в процессе обнуления или эпоха вне окна
+        if (state % 2 == 1 || current_epoch - state / 2 >= SLOT_COUNT) {
+            continue;
+        }
+        stats.requests += slot.requests.load(memory_order_relaxed);
+        stats.no_result_requests += slot.no_result_requests.load(memory_order_relaxed);
+        for (int i = 0; i < LATENCY_BUCKET_COUNT; ++i) {
+            latency[i] += slot.latency[i].load(memory_order_relaxed);
+        }
+        for (size_t i = 0; i < stats.result_counts.size(); ++i) {
+            stats.result_counts[i] += slot.result_counts[i].load(memory_order_relaxed);
+        }
+    }
+
+    const auto elapsed = min(now - start_time_, slot_duration_ * SLOT_COUNT);
+    if (elapsed.count() > 0) {
+        stats.queries_per_second = stats.requests / chrono::duration<double>(elapsed).count();
+    }
+
+    uint64_t seen = 0;
+    for (int i = 0; i < LATENCY_BUCKET_COUNT; ++i) {
+        if (latency[i] == 0) {
+            continue;
         }
-        requests_.pop_front();
+        const auto upper_bound = chrono::nanoseconds(GetLatencyBucketUpperBound(i));
+        seen += latency[i];
+        if (stats.latency_p50.count() == 0 && seen * 100 >= stats.requests * 50) {
+            stats.latency_p50 = upper_bound;
+        }
+        if (stats.latency_p90.count() == 0 && seen * 100 >= stats.requests * 90) {
+            stats.latency_p90 = upper_bound;
+        }
+        if (stats.latency_p99.count() == 0 && seen * 100 >= stats.requests * 99) {
+            stats.latency_p99 = upper_bound;
+        }
+        stats.latency_max = upper_bound;
     }
-    requests_.push_back({current_time_, results_num});
-    if (0 == results_num) {
-        ++no_results_requests_;
+    return stats;
+}
+
+void RequestQueue::AddRequest(size_t results_num, Clock::time_point start_time) {
+    const auto end_time = Clock::now();
+    Slot* slot = AcquireSlot(GetEpoch(end_time));
+    if (slot == nullptr) {
+        return;
+    }
+    const auto latency = chrono::duration_cast<chrono::nanoseconds>(end_time - start_time).count();
+    slot->requests.fetch_add(1, memory_order_relaxed);
+    if (results_num == 0) {
+        slot->no_result_requests.fetch_add(1, memory_order_relaxed);
+    }
+    slot->latency[GetLatencyBucket(static_cast<uint64_t>(max<int64_t>(latency, 0)))].fetch_add(1, memory_order_relaxed);
+    slot->result_counts[min<size_t>(results_num, MAX_RESULT_DOCUMENT_COUNT)].fetch_add(1, memory_order_relaxed);
+    ReleaseSlot(*slot);
+}
+
+uint64_t RequestQueue::GetEpoch(Clock::time_point time) const {
+    return static_cast<uint64_t>((time - start_time_) / slot_duration_);
+}
+
+//Первый запрос новой эпохи обнуляет слот, остальные потоки ждут только это обнуление.
+//Запрос, опоздавший к уже переиспользованному слоту, не учитывается.
+//Запрос регистрируется в writers до проверки эпохи слота и снимается после записи (ReleaseSlot),
+//а обнуляющий поток сначала помечает слот и затем ждёт writers == 0. Поэтому запрос, увидевший
+//старую эпоху, успевает дописать счётчики до обнуления и не попадает в статистику новой эпохи.
+//Порядок «запись, затем чтение» с обеих сторон требует memory_order_seq_cst
+RequestQueue::Slot* RequestQueue::AcquireSlot(uint64_t epoch) {
+    Slot& slot = slots_[epoch % SLOT_COUNT];
+    const uint64_t ready_state = epoch * 2;
+    while (true) {
+        slot.writers.fetch_add(1);
+        uint64_t state = slot.state.load();
+        if (state == ready_state) {
+            return &slot;
+        }
+        slot.writers.fetch_sub(1, memory_order_release);
+        if (state > ready_state + 1) {
+            return nullptr;
+        }
+        //слот обнуляется под эту или более раннюю эпоху: обнулять его можно только после этого
+        if (state % 2 == 1) {
+            while (slot.state.load(memory_order_acquire) == state) {
+                this_thread::yield();
+            }
+            continue;
+        }
+        //переход только из готового состояния прошлой эпохи, поэтому обнуляющий поток у слота один
+        if (slot.state.compare_exchange_weak(state, ready_state + 1)) {
+            //запросы прошлой эпохи, уже прошедшие проверку, дописывают счётчики
+            while (slot.writers.load() != 0) {
+                this_thread::yield();
+            }
+            slot.requests.store(0, memory_order_relaxed);
+            slot.no_result_requests.store(0, memory_order_relaxed);
+            for (auto& counter : slot.latency) {
+                counter.store(0, memory_order_relaxed);
+            }
+            for (auto& counter : slot.result_counts) {
+                counter.store(0, memory_order_relaxed);
+            }
+            //слот в состоянии ready_state + 1 никто, кроме этого потока, не меняет;
+            //сравнение с полным значением эпохи делает это явным
+            uint64_t zeroing_state = ready_state + 1;
+            [[maybe_unused]] const bool is_owner = slot.state.compare_exchange_strong(zeroing_state, ready_state, memory_order_release);
+            assert(is_owner);
+        }
+    }
+}
+
+void RequestQueue::ReleaseSlot(Slot& slot) {
+    slot.writers.fetch_sub(1, memory_order_release);
+}
+
+int RequestQueue::GetLatencyBucket(uint64_t nanoseconds) {
+    nanoseconds = min(nanoseconds, (uint64_t(1) << LATENCY_MAX_BITS) - 1);
+    if (nanoseconds < LATENCY_SUB_BUCKET_COUNT) {
+        return static_cast<int>(nanoseconds);
+    }
+    int top_bit = 0;
+    while ((nanoseconds >> (top_bit + 1)) != 0) {
+        ++top_bit;
+    }
+    const int shift = top_bit - LATENCY_SUB_BUCKET_BITS;
+    return (shift + 1) * LATENCY_SUB_BUCKET_COUNT
+           + static_cast<int>((nanoseconds >> shift) & (LATENCY_SUB_BUCKET_COUNT - 1));
+}
+
+uint64_t RequestQueue::GetLatencyBucketUpperBound(int bucket) {
+    if (bucket < LATENCY_SUB_BUCKET_COUNT) {
+        return static_cast<uint64_t>(bucket);
     }
+    const int shift = bucket / LATENCY_SUB_BUCKET_COUNT - 1;
+    const uint64_t mantissa = LATENCY_SUB_BUCKET_COUNT + bucket % LATENCY_SUB_BUCKET_COUNT;
+    return ((mantissa + 1) << shift) - 1;
 }
\ No newline at end of file
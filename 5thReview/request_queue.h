@@ -1,20 +1,41 @@
 #pragma once
 
+#include "query_cache.h"
 #include "search_server.h"
 
-#include <deque>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
 
 
 //Хранит в себе класс RequestQueue, принимающий запросы на поиск "AddFindRequest",
-//сам класс RequestQueue отвечает сколько запросов за последние сутки (1440 минут) отслось без результата
+//и статистику запросов за скользящее окно реального времени (по умолчанию сутки):
+//число запросов, число запросов без результата, QPS, гистограммы задержек и числа результатов.
+//Окно разбито на SLOT_COUNT слотов из атомарных счётчиков: обновление O(1) без блокировок,
+//память зависит только от размера гистограмм, снимок статистики не блокирует поток запросов
+
+//Снимок статистики за окно
+struct RequestStats {
+    uint64_t requests = 0;
+    uint64_t no_result_requests = 0;
+    double queries_per_second = 0.0;
+    std::chrono::nanoseconds latency_p50{};
+    std::chrono::nanoseconds latency_p90{};
+    std::chrono::nanoseconds latency_p99{};
+    std::chrono::nanoseconds latency_max{};
+    //result_counts[i] - число запросов, вернувших i документов
+    std::array<uint64_t, MAX_RESULT_DOCUMENT_COUNT + 1> result_counts{};
+};
 
 class RequestQueue {
 public:
-    explicit RequestQueue(const SearchServer& search_server)
-    : search_server_(search_server)
-    , no_results_requests_(0)
-    , current_time_(0)
-    {}
+    using Clock = std::chrono::steady_clock;
+
+    explicit RequestQueue(const SearchServer& search_server, std::chrono::nanoseconds window = std::chrono::hours(24));
+    //запросы по статусу обслуживаются через кеш результатов
+    explicit RequestQueue(QueryCache& query_cache, std::chrono::nanoseconds window = std::chrono::hours(24));
 
     //Объявление методов AddFindRequest
     std::vector<Document> AddFindRequest(const std::string& raw_query, DocumentStatus status);
@@ -23,24 +44,47 @@ public:
     //Реализация шаблонного метода AddFindRequest
     template <typename DocumentPredicate>
     std::vector<Document> AddFindRequest(const std::string& raw_query, DocumentPredicate document_predicate) {
+        const auto start_time = Clock::now();
         const auto result = search_server_.FindTopDocuments(raw_query, document_predicate);
-        AddRequest(result.size());
+        AddRequest(result.size(), start_time);
         return result;
     }
 
     int GetNoResultRequests() const;
+    RequestStats GetStats() const;
 
 private:
-    struct QueryResult {
-        uint64_t timestamp;
-        int results;
+    constexpr static int SLOT_COUNT = 60;
+
+    //Логарифмическая гистограмма в стиле HDR: в каждой октаве 2^LATENCY_SUB_BUCKET_BITS корзин,
+    //относительная погрешность 1/8. Задержки больше 2^LATENCY_MAX_BITS нс попадают в последнюю корзину
+    constexpr static int LATENCY_SUB_BUCKET_BITS = 3;
+    constexpr static int LATENCY_SUB_BUCKET_COUNT = 1 << LATENCY_SUB_BUCKET_BITS;
+    constexpr static int LATENCY_MAX_BITS = 41;
+    constexpr static int LATENCY_BUCKET_COUNT = (LATENCY_MAX_BITS - LATENCY_SUB_BUCKET_BITS + 1) * LATENCY_SUB_BUCKET_COUNT;
+
+    //state слота: 2 * epoch для готового слота, 2 * epoch + 1 пока слот обнуляется под новую эпоху.
+    //writers - число запросов, которые сейчас увеличивают счётчики слота
+    struct Slot {
+        std::atomic<uint64_t> state{0};
+        std::atomic<uint64_t> writers{0};
+        std::atomic<uint64_t> requests{0};
+        std::atomic<uint64_t> no_result_requests{0};
+        std::array<std::atomic<uint64_t>, LATENCY_BUCKET_COUNT> latency{};
+        std::array<std::atomic<uint64_t>, MAX_RESULT_DOCUMENT_COUNT + 1> result_counts{};
     };
-    std::deque<QueryResult> requests_;
+
     const SearchServer& search_server_;
-    int no_results_requests_;
-    uint64_t current_time_;
-    constexpr static int sec_in_day_ = 1440;
+    QueryCache* query_cache_ = nullptr;
+    const Clock::time_point start_time_;
+    const std::chrono::nanoseconds slot_duration_;
+    std::vector<Slot> slots_;
 
-    void AddRequest(int results_num);
-};
+    void AddRequest(size_t results_num, Clock::time_point start_time);
+    uint64_t GetEpoch(Clock::time_point time) const;
+    Slot* AcquireSlot(uint64_t epoch);
+    static void ReleaseSlot(Slot& slot);
 
+    static int GetLatencyBucket(uint64_t nanoseconds);
+    static uint64_t GetLatencyBucketUpperBound(int bucket);
+};
\ No newline at end of file
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "document.h"
+#include "ranking.h"
+#include "search_server.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <execution>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+//Курсор постраничной выдачи без ограничения MAX_RESULT_DOCUMENT_COUNT.
+//Состояние курсора - текст запроса, статус, функция ранжирования и последний выданный документ
+//(релевантность, рейтинг, id), поэтому его можно сохранить и продолжить выдачу позже.
+//Запрос разбирается один раз при создании курсора (ошибка в запросе - invalid_argument из конструктора).
+//Порядок выдачи совпадает с FindTopDocuments, поэтому первые страницы повторяют её результат.
+//Первая страница находит и сортирует все оставшиеся документы запроса, следующие берутся из них без повторного поиска.
+//Если версия индекса изменилась между страницами, документы ищутся заново от последнего выданного
+//в новом порядке ранжирования.
+//Слова разобранного запроса ссылаются на текст внутри курсора, поэтому курсор не копируется и не перемещается.
+//Подходит для StreamPaginator: PaginateStream(cursor, page_size)
+
+template <typename RankingPolicy = TfIdfRanking>
+class SearchCursor {
+public:
+    SearchCursor(const SearchServer& search_server, std::string_view raw_query,
+                 DocumentStatus status = DocumentStatus::ACTUAL,
+                 std::optional<Document> last_document = std::nullopt,
+                 RankingPolicy ranking = RankingPolicy{})
+        : search_server_(search_server)
+        , raw_query_(raw_query)
+        , query_(search_server.ParseQuery(raw_query_, std::pmr::get_default_resource()))
+        , status_(status)
+        , ranking_(ranking)
+        , last_document_(last_document)
+    {
+    }
+
+    SearchCursor(const SearchCursor&) = delete;
+    SearchCursor& operator=(const SearchCursor&) = delete;
+
+    std::vector<Document> NextPage(size_t page_size) {
+        return NextPage(std::execution::seq, page_size);
+    }
+
+    //политика используется при поиске документов; границы страниц устойчивы для seq,
+    //см. SearchServer::FindTopDocumentsAfter
+    template <typename ExecutionPolicy>
+    std::vector<Document> NextPage(const ExecutionPolicy& exec_policy, size_t page_size) {
+        if (exhausted_ || page_size == 0) {
+            return {};
+        }
+        //версия читается до поиска: изменение индекса во время поиска заметит следующая страница
+        const uint64_t index_version = search_server_.GetIndexVersion();
+        if (!ranked_version_ || *ranked_version_ != index_version) {
+            ranked_documents_ = search_server_.FindRankedDocumentsAfter(
+                    exec_policy, query_,
+                    StatusFilter{ status_ },
+                    last_document_, ranking_);
+            ranked_version_ = index_version;
+            next_document_ = 0;
+        }
+        const size_t page_end = next_document_ + std::min(page_size, ranked_documents_.size() - next_document_);
+        std::vector<Document> page(ranked_documents_.begin() + next_document_, ranked_documents_.begin() + page_end);
+        next_document_ = page_end;
+        if (page.size() < page_size) {
+            exhausted_ = true;
+        }
+        if (!page.empty()) {
+            last_document_ = page.back();
+        }
+        return page;
+    }
+
+    [[nodiscard]] bool IsExhausted() const {
+        return exhausted_;
+    }
+
+    [[nodiscard]] const std::optional<Document>& GetLastDocument() const {
+        return last_document_;
+    }
+
+private:
+    const SearchServer& search_server_;
+    const std::string raw_query_;
+    const SearchServer::Query query_;
+    const DocumentStatus status_;
+    const RankingPolicy ranking_;
+    std::optional<Document> last_document_;
+    bool exhausted_ = false;
+    //документы после last_document_ в порядке выдачи для версии индекса ranked_version_
+    std::vector<Document> ranked_documents_;
+    std::optional<uint64_t> ranked_version_;
+    size_t next_document_ = 0;
+};
@@ -1,11 +1,19 @@
 #include "search_server.h"
-#include "log_duration.h"
+#include "profiler.h"
 
+#include <algorithm>
 #include <cmath>
 #include <execution>
+#include <numeric>
 
 using namespace std;
 
+namespace {
+
+const double RELEVANCE_EPSILON = 1e-6;
+
+}
+
 //Реализация конструкторов класса SearchServer
 SearchServer::SearchServer(string_view stop_words_text)
         :SearchServer(SplitIntoWords(stop_words_text))
@@ -18,23 +26,81 @@ SearchServer::SearchServer(const string& stop_words_text)
 
 //Реализация метода AddDocument
 void SearchServer::AddDocument(int document_id, string_view document, DocumentStatus status, const vector<int>& ratings) {
+    PROFILE_SCOPE("AddDocument");
+    AddDocumentWords(document_id, SplitIntoWordsNoStop(document), status, ratings);
+}
+
+void SearchServer::AddDocuments(const vector<RawDocument>& documents) {
+    AddDocuments(execution::seq, documents);
+}
+void SearchServer::AddDocuments(const execution::sequenced_policy&, const vector<RawDocument>& documents) {
+    for (const RawDocument& document : documents) {
+        AddDocument(document.id, document.text, document.status, document.ratings);
+    }
+}
+//Исключение из параллельного алгоритма привело бы к std::terminate,
+//поэтому ошибки разбора сохраняются и выбрасываются при добавлении соответствующего документа
+void SearchServer::AddDocuments(const execution::parallel_policy&, const vector<RawDocument>& documents) {
+    PROFILE_SCOPE("AddDocuments");
+    vector<vector<string_view>> document_words(documents.size());
+    vector<exception_ptr> errors(documents.size());
+    vector<size_t> indexes(documents.size());
+    iota(indexes.begin(), indexes.end(), 0);
+    for_each(execution::par, indexes.begin(), indexes.end(),
+             [this, &documents, &document_words, &errors](size_t i) {
+                 try {
+                     document_words[i] = SplitIntoWordsNoStop(documents[i].text);
+                 } catch (...) {
+                     errors[i] = current_exception();
+                 }
+             });
+    for (size_t i = 0; i < documents.size(); ++i) {
+        if (errors[i]) {
+            rethrow_exception(errors[i]);
+        }
+        AddDocumentWords(documents[i].id, document_words[i], documents[i].status, documents[i].ratings);
+    }
+}
+
+void SearchServer::AddDocumentWords(int document_id, const vector<string_view>& words, DocumentStatus status, const vector<int>& ratings) {
     if ((document_id < 0) || (documents_.count(document_id) > 0)) {
         throw invalid_argument("document contains wrong id"s);
     }
-    vector<string_view> words = SplitIntoWordsNoStop(document);
     const double inv_word_count = 1.0 / words.size();
-    for (string_view& word : words) {
-        string s_word{ word };
-        if (words_in_docs_.count(s_word) == 0) {
-            words_in_docs_[s_word].first = s_word;
-            string_view sv_word{ words_in_docs_.at(s_word).first };
-            words_in_docs_.at(s_word).second = sv_word;
+    auto& document_freqs = document_words_freqs_[document_id];
+    for (const string_view word : words) {
+        auto word_it = words_in_docs_.find(word);
+        if (word_it == words_in_docs_.end()) {
+            string s_word{ word };
+            word_it = words_in_docs_.emplace(s_word, make_pair(s_word, string_view{})).first;
+            word_it->second.second = word_it->second.first;
+            AddStat(index_stats_, &QueryStats::allocations);
         }
-        word_to_document_freqs_[words_in_docs_.at(s_word).second][document_id] += inv_word_count;
-        document_words_freqs_[document_id][words_in_docs_.at(s_word).second] += inv_word_count;
+        const string_view stored_word = word_it->second.second;
+        const auto [posting_it, is_new_posting] = word_to_document_freqs_[stored_word].try_emplace(document_id, 0.0);
+        posting_it->second += inv_word_count;
+        document_freqs[stored_word] += inv_word_count;
+        AddStat(index_stats_, &QueryStats::map_lookups, 4);
+        AddStat(index_stats_, &QueryStats::allocations, is_new_posting ? 2 : 0);
     }
-    documents_.emplace(document_id, DocumentData{ ComputeAverageRating(ratings), status });
+    documents_.emplace(document_id, DocumentData{ ComputeAverageRating(ratings), status, static_cast<int>(words.size()) });
+    total_word_count_ += words.size();
+    SetStatusBit(document_id, status, true);
     document_ids_.insert(document_id);
+    ++index_version_;
+}
+
+void SearchServer::SetStatusBit(int document_id, DocumentStatus status, bool value) {
+    const size_t index = static_cast<size_t>(document_id);
+    if (index >= MAX_STATUS_BITMAP_SIZE) {
+        return;
+    }
+    if (index >= status_bitmaps_[0].size()) {
+        for (auto& bitmap : status_bitmaps_) {
+            bitmap.resize(index + 1);
+        }
+    }
+    status_bitmaps_[static_cast<size_t>(status)][index] = value;
 }
 
 //Реализация методов RemoveDocument
@@ -42,30 +108,19 @@ void SearchServer::RemoveDocument(int document_id) {
     RemoveDocument(execution::seq, document_id);
 }
 void SearchServer::RemoveDocument(const execution::sequenced_policy&, int document_id) {
-    if (document_ids_.count(document_id) == 1) {
-        for (auto [word, freq] : GetWordFrequencies(document_id)) {
-            word_to_document_freqs_[word].erase(document_id);
-            if (word_to_document_freqs_.count(word) == 1 && word_to_document_freqs_.at(word).size() == 0) {
-                string s_word{ word };
-                words_in_docs_.erase(s_word);
-            }
-        }
-        document_ids_.erase(document_id);
-        documents_.erase(document_id);
-        document_words_freqs_.erase(document_id);
-    }
-    return;
+    RemoveDocuments({ document_id });
 }
+//Списки документов разных слов независимы, поэтому удаление из них выполняется параллельно.
+//Опустевшие слова удаляются из словаря последовательно
 void SearchServer::RemoveDocument(const execution::parallel_policy&, int document_id) {
-    if (document_words_freqs_.count(document_id) == 0) {
+    PROFILE_SCOPE("RemoveDocument");
+    AddStat(index_stats_, &QueryStats::map_lookups);
+    const auto document_it = document_words_freqs_.find(document_id);
+    if (document_it == document_words_freqs_.end()) {
         return;
     }
 
-    document_ids_.erase(document_id);
-    documents_.erase(document_id);
-    document_words_freqs_.erase(document_id);
-
-    const auto& word_freqs = document_words_freqs_.at(document_id);
+    const auto& word_freqs = document_it->second;
     vector<string_view> words(word_freqs.size());
     transform(
             execution::par,
@@ -79,32 +134,128 @@ void SearchServer::RemoveDocument(const execution::parallel_policy&, int documen
             [this, document_id](string_view word) {
                 word_to_document_freqs_.at(word).erase(document_id);
             });
+    AddStat(index_stats_, &QueryStats::postings_scanned, words.size());
+    AddStat(index_stats_, &QueryStats::map_lookups, words.size() * 2);
+
+    for (const string_view word : words) {
+        const auto it = word_to_document_freqs_.find(word);
+        if (it->second.empty()) {
+            const auto word_it = words_in_docs_.find(word);
+            word_to_document_freqs_.erase(it);
+            words_in_docs_.erase(word_it);
+        }
+    }
+    AddStat(index_stats_, &QueryStats::map_lookups, words.size());
+
+    document_ids_.erase(document_id);
+    const DocumentData& document_data = documents_.at(document_id);
+    total_word_count_ -= document_data.word_count;
+    SetStatusBit(document_id, document_data.status, false);
+    documents_.erase(document_id);
+    document_words_freqs_.erase(document_it);
+    ++index_version_;
+}
+
+void SearchServer::RemoveDocuments(const vector<int>& document_ids) {
+    PROFILE_SCOPE("RemoveDocuments");
+    vector<string_view> touched_words;
+    for (const int document_id : document_ids) {
+        if (document_ids_.count(document_id) == 0) {
+            continue;
+        }
+        const auto& word_freqs = document_words_freqs_.at(document_id);
+        for (const auto& [word, freq] : word_freqs) {
+            word_to_document_freqs_.at(word).erase(document_id);
+            touched_words.push_back(word);
+        }
+        AddStat(index_stats_, &QueryStats::postings_scanned, word_freqs.size());
+        AddStat(index_stats_, &QueryStats::map_lookups, 2 + word_freqs.size() * 2);
+        document_ids_.erase(document_id);
+        const DocumentData& document_data = documents_.at(document_id);
+        total_word_count_ -= document_data.word_count;
+        SetStatusBit(document_id, document_data.status, false);
+        documents_.erase(document_id);
+        document_words_freqs_.erase(document_id);
+        ++index_version_;
+    }
+
+    //слово удаляется из словаря только после удаления ключа, ссылающегося на его строку
+    sort(touched_words.begin(), touched_words.end());
+    touched_words.erase(unique(touched_words.begin(), touched_words.end()), touched_words.end());
+    AddStat(index_stats_, &QueryStats::map_lookups, touched_words.size());
+    for (const string_view word : touched_words) {
+        const auto it = word_to_document_freqs_.find(word);
+        if (it != word_to_document_freqs_.end() && it->second.empty()) {
+            const auto word_it = words_in_docs_.find(word);
+            word_to_document_freqs_.erase(it);
+            words_in_docs_.erase(word_it);
+        }
+    }
 }
 
 //Реализация методов FindTopDocument
 vector<Document> SearchServer::FindTopDocuments(string_view raw_query, DocumentStatus status) const {
-    return FindTopDocuments(execution::seq, raw_query, [status](int document_id, DocumentStatus statusp, int rating) { return statusp == status; });
+    return FindTopDocuments(execution::seq, raw_query, StatusFilter{ status });
 }
 vector<Document> SearchServer::FindTopDocuments(string_view raw_query) const {
     return FindTopDocuments(execution::seq, raw_query, DocumentStatus::ACTUAL);
 }
 
+pair<vector<Document>, QueryStats> SearchServer::FindTopDocumentsWithStats(string_view raw_query) const {
+    return FindTopDocumentsWithStats(execution::seq, raw_query, DocumentStatus::ACTUAL);
+}
+
 int SearchServer::GetDocumentCount() const {
     return documents_.size();
 }
 
-const map<string_view, double>& SearchServer::GetWordFrequencies(int document_id) const {
+QueryStats SearchServer::GetIndexStats() const {
+    return index_stats_;
+}
+
+double SearchServer::GetAverageDocumentLength() const {
+    if (documents_.empty()) {
+        return 0;
+    }
+    return static_cast<double>(total_word_count_) / documents_.size();
+}
+
+uint64_t SearchServer::GetIndexVersion() const {
+    return index_version_;
+}
+
+string SearchServer::NormalizeQuery(string_view raw_query) const {
+    QueryArenaScope arena_scope;
+    const Query query = ParseQuery(raw_query);
+    string result;
+    for (const string_view word : query.plus_words) {
+        if (!result.empty()) {
+            result.push_back(' ');
+        }
+        result += word;
+    }
+    for (const string_view word : query.minus_words) {
+        if (!result.empty()) {
+            result.push_back(' ');
+        }
+        result.push_back('-');
+        result += word;
+    }
+    return result;
+}
+
+const SearchServer::WordFrequencies& SearchServer::GetWordFrequencies(int document_id) const {
     if (document_ids_.count(document_id) == 1) {
         return document_words_freqs_.at(document_id);
     }
-    static map<string_view, double> empty_map;
+    static const WordFrequencies empty_map;
     return empty_map;
 }
 
-set<int>::const_iterator SearchServer::begin() const {
+pmr::set<int>::const_iterator SearchServer::begin() const {
     return document_ids_.begin();
 }
-set<int>::const_iterator SearchServer::end() const {
+pmr::set<int>::const_iterator SearchServer::end() const {
     return document_ids_.end();
 }
 
@@ -112,68 +263,16 @@ set<int>::const_iterator SearchServer::end() const {
 std::tuple<std::vector<std::string_view>, DocumentStatus> SearchServer::MatchDocument(string_view raw_query, int document_id) const {
     return MatchDocument(execution::seq, raw_query, document_id);
 }
-std::tuple<std::vector<std::string_view>, DocumentStatus> SearchServer::MatchDocument(const execution::sequenced_policy&, string_view raw_query, int document_id) const {
-    if (document_ids_.count(document_id) == 0) {
-        return { {}, {} };
-    }
-    const Query query = ParseQuery(raw_query);
-
-    const auto word_checker =
-            [this, document_id](string_view word) {
-                const auto it = word_to_document_freqs_.find(word);
-                return it != word_to_document_freqs_.end() && it->second.count(document_id);
-            };
-
-
-    if (any_of(execution::seq,
-               query.minus_words.begin(), query.minus_words.end(),
-               word_checker)) {
-        vector<string_view> empty;
-        return { empty, documents_.at(document_id).status };
-    }
-
-    vector<string_view> matched_words(query.plus_words.size());
-    auto words_end = copy_if(execution::seq,
-                             query.plus_words.begin(), query.plus_words.end(),
-                             matched_words.begin(),
-                             word_checker
-    );
-    sort(matched_words.begin(), words_end);
-    words_end = unique(matched_words.begin(), words_end);
-    matched_words.erase(words_end, matched_words.end());
-
-    return make_tuple(matched_words, documents_.at(document_id).status);
+std::tuple<std::vector<std::string_view>, DocumentStatus> SearchServer::MatchDocument(const execution::sequenced_policy& policy, string_view raw_query, int document_id) const {
+    NoStatsRecorder recorder;
+    return MatchDocument(policy, raw_query, document_id, recorder);
 }
-std::tuple<std::vector<std::string_view>, DocumentStatus> SearchServer::MatchDocument(const execution::parallel_policy&, string_view raw_query, int document_id) const {
-    if (document_ids_.count(document_id) == 0) {
-        return { {}, {} };
-    }
-    const Query query = ParseQuery(raw_query);
-
-    const auto word_checker =
-            [this, document_id](string_view word) {
-                const auto it = word_to_document_freqs_.find(word);
-                return it != word_to_document_freqs_.end();
-            };
-
-    if (any_of(execution::par,
-               query.minus_words.begin(), query.minus_words.end(),
-               word_checker)) {
-        vector<string_view> empty;
-        return { empty, documents_.at(document_id).status };
-    }
-
-    vector<string_view> matched_words(query.plus_words.size());
-    auto words_end = copy_if(execution::par,
-                             query.plus_words.begin(), query.plus_words.end(),
-                             matched_words.begin(),
-                             word_checker
-    );
-    sort(std::execution::par, matched_words.begin(), words_end);
-    words_end = unique(matched_words.begin(), words_end);
-    matched_words.erase(words_end, matched_words.end());
-
-    return make_tuple(matched_words, documents_.at(document_id).status);
+std::tuple<std::vector<std::string_view>, DocumentStatus> SearchServer::MatchDocument(const execution::parallel_policy& policy, string_view raw_query, int document_id) const {
+    NoStatsRecorder recorder;
+    return MatchDocument(policy, raw_query, document_id, recorder);
+}
+pair<tuple<vector<string_view>, DocumentStatus>, QueryStats> SearchServer::MatchDocumentWithStats(string_view raw_query, int document_id) const {
+    return MatchDocumentWithStats(execution::seq, raw_query, document_id);
 }
 
 bool SearchServer::IsStopWord(string_view word) const {
@@ -192,7 +291,8 @@ vector<string_view> SearchServer::SplitIntoWordsNoStop(string_view text) const {
             string s_word(word.begin(), word.end());
             throw invalid_argument("Word "s + string(s_word) + " is invalid"s);
         }
-        if (!IsStopWord(word)) {
+        //подряд идущие разделители не дают пустых слов
+        if (!word.empty() && !IsStopWord(word)) {
             words.push_back(word);
         }
     }
@@ -210,6 +310,21 @@ int SearchServer::ComputeAverageRating(const vector<int>& ratings) {
     return rating_sum / static_cast<int>(ratings.size());
 }
 
+//Релевантности сравниваются по номеру интервала шириной 1e-6, а не по |lhs - rhs| < 1e-6:
+//равенство с допуском не транзитивно, и сортировка с ним не задаёт однозначного порядка,
+//по которому курсор мог бы продолжить выдачу с последнего документа
+bool SearchServer::IsRankedBefore(const Document& lhs, const Document& rhs) {
+    const long long lhs_relevance = llround(lhs.relevance / RELEVANCE_EPSILON);
+    const long long rhs_relevance = llround(rhs.relevance / RELEVANCE_EPSILON);
+    if (lhs_relevance != rhs_relevance) {
+        return lhs_relevance > rhs_relevance;
+    }
+    if (lhs.rating != rhs.rating) {
+        return lhs.rating > rhs.rating;
+    }
+    return lhs.id < rhs.id;
+}
+
 SearchServer::QueryWord SearchServer::ParseQueryWord(string_view text) const {
     if (text.empty()) {
         throw invalid_argument("Query word is empty"s);
@@ -225,8 +340,13 @@ SearchServer::QueryWord SearchServer::ParseQueryWord(string_view text) const {
     return { text, is_minus, IsStopWord(text) };
 }
 SearchServer::Query SearchServer::ParseQuery(const string_view& text) const {
-    Query result = {};
-    for (const string_view word : SplitIntoWords(text)) {
+    return ParseQuery(text, QueryArenaScope::GetResource());
+}
+
+SearchServer::Query SearchServer::ParseQuery(string_view text, pmr::memory_resource* resource) const {
+    PROFILE_SCOPE("ParseQuery");
+    Query result(resource);
+    for (const string_view word : SplitIntoWords(text, resource)) {
         QueryWord query_word = ParseQueryWord(word);
         if (!query_word.is_stop) {
             if (query_word.is_minus) {
@@ -238,8 +358,4 @@ SearchServer::Query SearchServer::ParseQuery(const string_view& text) const {
         }
     }
     return result;
-}
-
-double SearchServer::ComputeWordInverseDocumentFreq(string_view word) const {
-    return log(GetDocumentCount() * 1.0 / word_to_document_freqs_.at(word).size());
 }
\ No newline at end of file
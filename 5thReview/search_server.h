@@ -3,12 +3,19 @@
 #include "document.h"
 #include "string_processing.h"
 #include "concurrent_map.h"
-#include "log_duration.h"
+#include "search_stats.h"
+#include "profiler.h"
+#include "query_arena.h"
+#include "ranking.h"
 
+#include <array>
 #include <execution>
 #include <map>
+#include <memory>
+#include <memory_resource>
 #include <set>
 #include <future>
+#include <optional>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -16,6 +23,9 @@
 
 const int MAX_RESULT_DOCUMENT_COUNT = 5;
 
+template <typename RankingPolicy>
+class SearchCursor;
+
 template <typename ExecutionPolicy, typename ForwardRange, typename Function>
 void ForEach(const ExecutionPolicy& policy, ForwardRange& range, Function function) {
     if constexpr (
@@ -54,6 +64,7 @@ void ForEach(ForwardRange& range, Function function) {
 
 class SearchServer {
 public:
+    using WordFrequencies = std::pmr::map<std::string_view, double>;
 
     //объявление конструкторов SearchServer
     explicit SearchServer(const std::string& stop_words_text);
@@ -71,10 +82,18 @@ public:
     //объявление метода AddDocument
     void AddDocument(int document_id, std::string_view document, DocumentStatus status, const std::vector<int>& ratings);
 
+    //пакетное добавление: документы разбиваются на слова (параллельно для par), затем по порядку добавляются в индекс.
+    //Текст документов нужен только на время вызова. При ошибке документы до ошибочного остаются добавленными
+    void AddDocuments(const std::vector<RawDocument>& documents);
+    void AddDocuments(const std::execution::sequenced_policy&, const std::vector<RawDocument>& documents);
+    void AddDocuments(const std::execution::parallel_policy&, const std::vector<RawDocument>& documents);
+
     //объявление методов RemoveDocument
     void RemoveDocument(int document_id);
     void RemoveDocument(const std::execution::sequenced_policy&, int document_id);
     void RemoveDocument(const std::execution::parallel_policy&, int document_id);
+    //пакетное удаление: общие для документов слова чистятся из индекса один раз
+    void RemoveDocuments(const std::vector<int>& document_ids);
 
     //объявление методов FindTopDocuments
     [[nodiscard]] std::vector<Document> FindTopDocuments(std::string_view raw_query, DocumentStatus status) const;
@@ -87,60 +106,147 @@ public:
     }
     template <typename ExecutionPolicy, typename DocumentPredicate>
     std::vector<Document> FindTopDocuments(const ExecutionPolicy exec_policy, std::string_view raw_query, DocumentPredicate document_predicate) const {
-        //LOG_DURATION("FindTopDocuments");
-        Query query = ParseQuery(raw_query);
-        std::vector<Document> matched_documents = FindAllDocuments(exec_policy, query, document_predicate);
-        sort(matched_documents.begin(), matched_documents.end(), [](const Document& lhs, const Document& rhs) {
-            if (std::abs(lhs.relevance - rhs.relevance) < 1e-6) {
-                return lhs.rating > rhs.rating;
-            }
-            else {
-                return lhs.relevance > rhs.relevance;
-            }
-        });
-        if (matched_documents.size() > MAX_RESULT_DOCUMENT_COUNT) {
-            matched_documents.resize(MAX_RESULT_DOCUMENT_COUNT);
-        }
-        return matched_documents;
+        return FindTopDocuments(exec_policy, raw_query, document_predicate, TfIdfRanking{});
+    }
+    //ранжирование заданной политикой (TfIdfRanking, Bm25Ranking, см. ranking.h)
+    template <typename ExecutionPolicy, typename DocumentPredicate, typename RankingPolicy>
+    std::vector<Document> FindTopDocuments(const ExecutionPolicy exec_policy, std::string_view raw_query, DocumentPredicate document_predicate, const RankingPolicy& ranking) const {
+        NoStatsRecorder recorder;
+        return FindTopDocuments(exec_policy, raw_query, document_predicate, ranking, recorder);
+    }
+    template <typename ExecutionPolicy, typename RankingPolicy>
+    std::vector<Document> FindTopDocuments(const ExecutionPolicy exec_policy, std::string_view raw_query, DocumentStatus status, const RankingPolicy& ranking) const {
+        return FindTopDocuments(exec_policy, raw_query, StatusFilter{ status }, ranking);
     }
+    //Страница из count документов, следующих в порядке ранжирования за документом after
+    //(или с начала выдачи, если after не задан). Сортируются только документы страницы.
+    //Порядок тот же, что у FindTopDocuments, включая разбор равных релевантностей по рейтингу и id,
+    //поэтому первая страница совпадает с началом выдачи FindTopDocuments.
+    //При параллельной политике порядок сложения вкладов слов не фиксирован и релевантность может
+    //отличаться в последних битах от вызова к вызову, поэтому для устойчивых границ нужна seq
+    template <typename ExecutionPolicy, typename DocumentPredicate>
+    std::vector<Document> FindTopDocumentsAfter(const ExecutionPolicy exec_policy, std::string_view raw_query, DocumentPredicate document_predicate,
+                                                const std::optional<Document>& after, size_t count) const {
+        return FindTopDocumentsAfter(exec_policy, raw_query, document_predicate, after, count, TfIdfRanking{});
+    }
+    template <typename ExecutionPolicy, typename DocumentPredicate, typename RankingPolicy>
+    std::vector<Document> FindTopDocumentsAfter(const ExecutionPolicy exec_policy, std::string_view raw_query, DocumentPredicate document_predicate,
+                                                const std::optional<Document>& after, size_t count, const RankingPolicy& ranking) const {
+        QueryArenaScope arena_scope;
+        const Query query = ParseQuery(raw_query);
+        return FindTopDocumentsAfter(exec_policy, query, document_predicate, after, count, ranking);
+    }
+
     template <typename ExecutionPolicy>
     std::vector<Document> FindTopDocuments(const  ExecutionPolicy exec_policy, std::string_view raw_query) const {
         return FindTopDocuments(exec_policy, raw_query, DocumentStatus::ACTUAL);
     }
     template <typename ExecutionPolicy>
     std::vector<Document> FindTopDocuments(const  ExecutionPolicy exec_policy, std::string_view raw_query, DocumentStatus status) const {
-        return FindTopDocuments(exec_policy, raw_query, [status](int document_id, DocumentStatus statusp, int rating) { return statusp == status; });
+        return FindTopDocuments(exec_policy, raw_query, StatusFilter{ status });
+    }
+
+    //Варианты FindTopDocuments, возвращающие вместе с результатом счётчики стоимости запроса.
+    //При SEARCH_SERVER_COLLECT_STATS=0 счётчики не собираются и остаются нулевыми
+    [[nodiscard]] std::pair<std::vector<Document>, QueryStats> FindTopDocumentsWithStats(std::string_view raw_query) const;
+
+    template <typename ExecutionPolicy, typename DocumentPredicate>
+    std::pair<std::vector<Document>, QueryStats> FindTopDocumentsWithStats(const ExecutionPolicy exec_policy, std::string_view raw_query, DocumentPredicate document_predicate) const {
+        return FindTopDocumentsWithStats(exec_policy, raw_query, document_predicate, TfIdfRanking{});
+    }
+    template <typename ExecutionPolicy, typename DocumentPredicate, typename RankingPolicy>
+    std::pair<std::vector<Document>, QueryStats> FindTopDocumentsWithStats(const ExecutionPolicy exec_policy, std::string_view raw_query, DocumentPredicate document_predicate,
+                                                                           const RankingPolicy& ranking) const {
+        StatsRecorder<COLLECT_SEARCH_STATS> recorder;
+        std::vector<Document> documents = FindTopDocuments(exec_policy, raw_query, document_predicate, ranking, recorder);
+        return { std::move(documents), recorder.GetStats() };
+    }
+    template <typename ExecutionPolicy, typename RankingPolicy>
+    std::pair<std::vector<Document>, QueryStats> FindTopDocumentsWithStats(const ExecutionPolicy exec_policy, std::string_view raw_query, DocumentStatus status,
+                                                                           const RankingPolicy& ranking) const {
+        return FindTopDocumentsWithStats(exec_policy, raw_query, StatusFilter{ status }, ranking);
+    }
+    template <typename ExecutionPolicy>
+    std::pair<std::vector<Document>, QueryStats> FindTopDocumentsWithStats(const ExecutionPolicy exec_policy, std::string_view raw_query) const {
+        return FindTopDocumentsWithStats(exec_policy, raw_query, DocumentStatus::ACTUAL);
+    }
+    template <typename ExecutionPolicy>
+    std::pair<std::vector<Document>, QueryStats> FindTopDocumentsWithStats(const ExecutionPolicy exec_policy, std::string_view raw_query, DocumentStatus status) const {
+        return FindTopDocumentsWithStats(exec_policy, raw_query, StatusFilter{ status });
     }
 
     [[nodiscard]] int GetDocumentCount() const;
 
-    [[nodiscard]] const std::map<std::string_view, double>& GetWordFrequencies(int document_id) const;
+    //среднее число слов (без стоп-слов) в документе, используется BM25
+    [[nodiscard]] double GetAverageDocumentLength() const;
 
-    [[nodiscard]] std::set<int>::const_iterator begin() const;
-    [[nodiscard]] std::set<int>::const_iterator end() const;
+    //накопленные счётчики AddDocument и RemoveDocument
+    [[nodiscard]] QueryStats GetIndexStats() const;
+
+    //версия индекса увеличивается при каждом добавлении и удалении документов
+    [[nodiscard]] uint64_t GetIndexVersion() const;
+
+    //каноническая запись запроса: плюс-слова и минус-слова без повторов и стоп-слов в лексикографическом порядке
+    [[nodiscard]] std::string NormalizeQuery(std::string_view raw_query) const;
+
+    [[nodiscard]] const WordFrequencies& GetWordFrequencies(int document_id) const;
+
+    [[nodiscard]] std::pmr::set<int>::const_iterator begin() const;
+    [[nodiscard]] std::pmr::set<int>::const_iterator end() const;
 
     //объявление методов MatchDocument
     [[nodiscard]] std::tuple<std::vector<std::string_view>, DocumentStatus> MatchDocument(std::string_view raw_query, int document_id) const;
     [[nodiscard]] std::tuple<std::vector<std::string_view>, DocumentStatus> MatchDocument(const std::execution::sequenced_policy&, std::string_view raw_query, int document_id) const;
     [[nodiscard]] std::tuple<std::vector<std::string_view>, DocumentStatus> MatchDocument(const std::execution::parallel_policy&, std::string_view raw_query, int document_id) const;
 
+    template <typename ExecutionPolicy>
+    std::pair<std::tuple<std::vector<std::string_view>, DocumentStatus>, QueryStats> MatchDocumentWithStats(const ExecutionPolicy exec_policy, std::string_view raw_query, int document_id) const {
+        StatsRecorder<COLLECT_SEARCH_STATS> recorder;
+        auto result = MatchDocument(exec_policy, raw_query, document_id, recorder);
+        return { std::move(result), recorder.GetStats() };
+    }
+    [[nodiscard]] std::pair<std::tuple<std::vector<std::string_view>, DocumentStatus>, QueryStats> MatchDocumentWithStats(std::string_view raw_query, int document_id) const;
+
 private:
     struct DocumentData {
         int rating = {};
         DocumentStatus status = {};
+        int word_count = {};
     };
 
-    std::map<std::string, std::pair<std::string, std::string_view>> words_in_docs_;
+    //узлы индекса выделяются из общего пула; пул потокобезопасный, так как параллельный
+    //RemoveDocument освобождает узлы разных слов одновременно.
+    //Объявлен раньше контейнеров, чтобы разрушаться после них, и хранится по указателю,
+    //чтобы при перемещении сервера контейнеры ссылались на тот же пул
+    std::unique_ptr<std::pmr::synchronized_pool_resource> index_resource_ = std::make_unique<std::pmr::synchronized_pool_resource>();
+    std::pmr::map<std::string, std::pair<std::string, std::string_view>, std::less<>> words_in_docs_{ index_resource_.get() };
     const std::set<std::string, std::less<>> stop_words_;
-    std::map<std::string_view, std::map<int, double>> word_to_document_freqs_;
-    std::map<int, DocumentData> documents_;
-    std::set<int> document_ids_;
-    std::map<int, std::map<std::string_view, double>> document_words_freqs_;
+    std::pmr::map<std::string_view, std::pmr::map<int, double>> word_to_document_freqs_{ index_resource_.get() };
+    std::pmr::map<int, DocumentData> documents_{ index_resource_.get() };
+    std::pmr::set<int> document_ids_{ index_resource_.get() };
+    std::pmr::map<int, WordFrequencies> document_words_freqs_{ index_resource_.get() };
+    //битовые карты статусов по id документа: фильтр StatusFilter проверяет бит вместо поиска в documents_.
+    //Карты ограничены MAX_STATUS_BITMAP_SIZE id, документы с большими id проверяются через documents_
+    static constexpr size_t STATUS_COUNT = static_cast<size_t>(DocumentStatus::REMOVED) + 1;
+    static constexpr size_t MAX_STATUS_BITMAP_SIZE = size_t{ 1 } << 24;
+    std::array<std::vector<bool>, STATUS_COUNT> status_bitmaps_;
+    uint64_t total_word_count_ = 0;
+    uint64_t index_version_ = 0;
+    QueryStats index_stats_;
 
     [[nodiscard]] bool IsStopWord(std::string_view word) const;
     static bool IsValidWord(std::string_view word);
 
     [[nodiscard]] std::vector<std::string_view> SplitIntoWordsNoStop(std::string_view text) const;
+    void SetStatusBit(int document_id, DocumentStatus status, bool value);
+    [[nodiscard]] bool HasStatus(int document_id, DocumentStatus status) const {
+        const size_t index = static_cast<size_t>(document_id);
+        if (index < status_bitmaps_[0].size()) {
+            return status_bitmaps_[static_cast<size_t>(status)][index];
+        }
+        return index >= MAX_STATUS_BITMAP_SIZE && documents_.at(document_id).status == status;
+    }
+    void AddDocumentWords(int document_id, const std::vector<std::string_view>& words, DocumentStatus status, const std::vector<int>& ratings);
     static int ComputeAverageRating(const std::vector<int>& ratings);
 
     struct QueryWord {
@@ -149,30 +255,102 @@ private:
         bool is_stop;
     };
 
+    //порядок выдачи: по убыванию релевантности, при равной релевантности - по убыванию рейтинга, затем по id.
+    //Релевантности, отличающиеся меньше чем на 1e-6, считаются равными
+    static bool IsRankedBefore(const Document& lhs, const Document& rhs);
+
     [[nodiscard]] QueryWord ParseQueryWord(std::string_view text) const;
 
+    //слова запроса размещаются в арене текущей области запроса
     struct Query {
-        std::set<std::string_view> plus_words;
-        std::set<std::string_view> minus_words;
+        explicit Query(std::pmr::memory_resource* resource)
+                : plus_words(resource)
+                , minus_words(resource) {
+        }
+        std::pmr::set<std::string_view> plus_words;
+        std::pmr::set<std::string_view> minus_words;
     };
 
     [[nodiscard]] Query ParseQuery(const std::string_view& text) const;
+    //слова запроса ссылаются на text и размещаются в resource
+    [[nodiscard]] Query ParseQuery(std::string_view text, std::pmr::memory_resource* resource) const;
 
-    [[nodiscard]] double ComputeWordInverseDocumentFreq(std::string_view word) const;
+    //курсор разбирает запрос один раз и выполняет его для каждой страницы
+    template <typename RankingPolicy>
+    friend class SearchCursor;
 
-    //реализация приватного шаблонного метода FindAllDocuments
-    template <typename ExecutionPolicy, typename DocumentPredicate>
-    std::vector<Document> FindAllDocuments(const ExecutionPolicy exec_policy, const Query& query, DocumentPredicate document_predicate) const {
-        ConcurrentMap<int, double> document_to_relevance((query.plus_words).size());
-        std::set<int> stop_ids;
+    //документы запроса, следующие в порядке ранжирования за after, без сортировки
+    template <typename ExecutionPolicy, typename DocumentPredicate, typename RankingPolicy>
+    std::pmr::vector<Document> FindAllDocumentsAfter(const ExecutionPolicy exec_policy, const Query& query, DocumentPredicate document_predicate,
+                                                     const std::optional<Document>& after, const RankingPolicy& ranking) const {
+        NoStatsRecorder recorder;
+        std::pmr::vector<Document> matched_documents = FindAllDocuments(exec_policy, query, document_predicate, ranking, recorder);
+        if (after) {
+            matched_documents.erase(remove_if(matched_documents.begin(), matched_documents.end(),
+                                              [&after](const Document& document) { return !IsRankedBefore(*after, document); }),
+                                    matched_documents.end());
+        }
+        return matched_documents;
+    }
+
+    template <typename ExecutionPolicy, typename DocumentPredicate, typename RankingPolicy>
+    std::vector<Document> FindTopDocumentsAfter(const ExecutionPolicy exec_policy, const Query& query, DocumentPredicate document_predicate,
+                                                const std::optional<Document>& after, size_t count, const RankingPolicy& ranking) const {
+        QueryArenaScope arena_scope;
+        std::pmr::vector<Document> matched_documents = FindAllDocumentsAfter(exec_policy, query, document_predicate, after, ranking);
+        const auto page_end = matched_documents.begin() + std::min(count, matched_documents.size());
+        partial_sort(matched_documents.begin(), page_end, matched_documents.end(), IsRankedBefore);
+        return { matched_documents.begin(), page_end };
+    }
+
+    //все документы запроса после after в порядке выдачи
+    template <typename ExecutionPolicy, typename DocumentPredicate, typename RankingPolicy>
+    std::vector<Document> FindRankedDocumentsAfter(const ExecutionPolicy exec_policy, const Query& query, DocumentPredicate document_predicate,
+                                                   const std::optional<Document>& after, const RankingPolicy& ranking) const {
+        QueryArenaScope arena_scope;
+        std::pmr::vector<Document> matched_documents = FindAllDocumentsAfter(exec_policy, query, document_predicate, after, ranking);
+        sort(matched_documents.begin(), matched_documents.end(), IsRankedBefore);
+        return { matched_documents.begin(), matched_documents.end() };
+    }
+
+    template <typename ExecutionPolicy, typename DocumentPredicate, typename RankingPolicy, typename Recorder>
+    std::vector<Document> FindTopDocuments(const ExecutionPolicy exec_policy, std::string_view raw_query, DocumentPredicate document_predicate,
+                                           const RankingPolicy& ranking, Recorder& recorder) const {
+        PROFILE_SCOPE("FindTopDocuments");
+        QueryArenaScope arena_scope;
+        Query query = ParseQuery(raw_query);
+        std::pmr::vector<Document> matched_documents = FindAllDocuments(exec_policy, query, document_predicate, ranking, recorder);
+        sort(matched_documents.begin(), matched_documents.end(), IsRankedBefore);
+        const size_t result_count = std::min<size_t>(matched_documents.size(), MAX_RESULT_DOCUMENT_COUNT);
+        return { matched_documents.begin(), matched_documents.begin() + result_count };
+    }
+
+    //реализация приватного шаблонного метода FindAllDocuments.
+    //Промежуточные структуры и результат размещаются в арене запроса, поэтому результат
+    //действителен только внутри QueryArenaScope вызывающего метода
+    template <typename ExecutionPolicy, typename DocumentPredicate, typename RankingPolicy, typename Recorder>
+    std::pmr::vector<Document> FindAllDocuments(const ExecutionPolicy exec_policy, const Query& query, DocumentPredicate document_predicate,
+                                                const RankingPolicy& ranking, Recorder& recorder) const {
+        PROFILE_SCOPE("FindAllDocuments");
+        std::pmr::memory_resource* const resource = QueryArenaScope::GetResource();
+        ConcurrentMap<int, double, std::pmr::polymorphic_allocator<std::pair<const int, double>>>
+                document_to_relevance((query.plus_words).size(), resource);
+        std::pmr::set<int> stop_ids(resource);
+        const double average_document_length = GetAverageDocumentLength();
         std::mutex m;
         ForEach(exec_policy,
                 query.minus_words,
-                [this, &stop_ids, &m](std::string_view word) {
-                    if (word_to_document_freqs_.count(word)) {
-                        for (const auto[document_id, _] : word_to_document_freqs_.at(word)) {
-                            std::lock_guard guard(m);
-                            stop_ids.insert(document_id);
+                [this, &stop_ids, &m, &recorder](std::string_view word) {
+                    recorder.Add(StatsCounter::MAP_LOOKUPS);
+                    const auto word_it = word_to_document_freqs_.find(word);
+                    if (word_it != word_to_document_freqs_.end()) {
+                        recorder.Add(StatsCounter::POSTINGS_SCANNED, word_it->second.size());
+                        for (const auto[document_id, _] : word_it->second) {
+                            LockCounted(m, recorder);
+                            std::lock_guard guard(m, std::adopt_lock);
+                            if (stop_ids.insert(document_id).second) {
+                                recorder.Add(StatsCounter::ALLOCATIONS);
+                            }
                         }
                     }
                 });
@@ -180,25 +358,100 @@ private:
         ForEach(
                 exec_policy,
                 query.plus_words,
-                [this, document_predicate, &document_to_relevance, &stop_ids](std::string_view word) {
-                    if (word_to_document_freqs_.count(word)) {
-                        const double inverse_document_freq = ComputeWordInverseDocumentFreq(word);
-
-                        for (const auto[document_id, term_freq] : word_to_document_freqs_.at(word)) {
-                            const auto &document_data = documents_.at(document_id);
-                            if (document_predicate(document_id, document_data.status, document_data.rating) &&
-                                (stop_ids.count(document_id) == 0)) {
-                                document_to_relevance[document_id].ref_to_value +=
-                                        term_freq * inverse_document_freq;
+                [this, document_predicate, &ranking, average_document_length, &document_to_relevance, &stop_ids, &recorder](std::string_view word) {
+                    recorder.Add(StatsCounter::MAP_LOOKUPS);
+                    const auto word_it = word_to_document_freqs_.find(word);
+                    if (word_it != word_to_document_freqs_.end()) {
+                        const double inverse_document_freq = ranking.ComputeInverseDocumentFreq(GetDocumentCount(), word_it->second.size());
+                        uint64_t lookups = 1;
+                        uint64_t filtered = 0;
+                        uint64_t scored = 0;
+
+                        for (const auto[document_id, term_freq] : word_it->second) {
+                            int document_length = 0;
+                            if constexpr (std::is_same_v<DocumentPredicate, StatusFilter>) {
+                                if (!HasStatus(document_id, document_predicate.status)) {
+                                    continue;
+                                }
+                                if constexpr (RankingPolicy::USES_DOCUMENT_LENGTH) {
+                                    document_length = documents_.at(document_id).word_count;
+                                    ++lookups;
+                                }
+                            } else {
+                                const auto &document_data = documents_.at(document_id);
+                                ++lookups;
+                                if (!document_predicate(document_id, document_data.status, document_data.rating)) {
+                                    continue;
+                                }
+                                document_length = document_data.word_count;
                             }
+                            ++lookups;
+                            if (stop_ids.count(document_id) != 0) {
+                                ++filtered;
+                                continue;
+                            }
+                            document_to_relevance.Get(document_id, recorder).ref_to_value +=
+                                    ranking.ComputeTermScore(term_freq, document_length, average_document_length) * inverse_document_freq;
+                            ++scored;
                         }
+                        recorder.Add(StatsCounter::POSTINGS_SCANNED, word_it->second.size());
+                        recorder.Add(StatsCounter::MAP_LOOKUPS, lookups);
+                        recorder.Add(StatsCounter::MINUS_FILTERED, filtered);
+                        recorder.Add(StatsCounter::DOCUMENTS_SCORED, scored);
                     }
                 });
-        std::vector<Document> matched_documents;
-        for (const auto [document_id, relevance] : document_to_relevance.BuildOrdinaryMap()) {
+        const auto document_relevances = document_to_relevance.BuildOrdinaryMap();
+        std::pmr::vector<Document> matched_documents(resource);
+        matched_documents.reserve(document_relevances.size());
+        for (const auto [document_id, relevance] : document_relevances) {
             matched_documents.push_back({ document_id, relevance, documents_.at(document_id).rating });
         }
+        recorder.Add(StatsCounter::ALLOCATIONS, matched_documents.size());
+        recorder.Add(StatsCounter::MAP_LOOKUPS, matched_documents.size());
 
         return matched_documents;
     }
+
+    //реализация приватного шаблонного метода MatchDocument
+    template <typename ExecutionPolicy, typename Recorder>
+    std::tuple<std::vector<std::string_view>, DocumentStatus> MatchDocument(const ExecutionPolicy exec_policy, std::string_view raw_query, int document_id, Recorder& recorder) const {
+        PROFILE_SCOPE("MatchDocument");
+        QueryArenaScope arena_scope;
+        recorder.Add(StatsCounter::MAP_LOOKUPS);
+        const auto document_it = documents_.find(document_id);
+        if (document_it == documents_.end()) {
+            return { {}, {} };
+        }
+        const Query query = ParseQuery(raw_query);
+
+        const auto word_checker =
+                [this, document_id, &recorder](std::string_view word) {
+                    recorder.Add(StatsCounter::MAP_LOOKUPS);
+                    const auto it = word_to_document_freqs_.find(word);
+                    if (it == word_to_document_freqs_.end()) {
+                        return false;
+                    }
+                    recorder.Add(StatsCounter::MAP_LOOKUPS);
+                    return it->second.count(document_id) > 0;
+                };
+
+        if (any_of(exec_policy,
+                   query.minus_words.begin(), query.minus_words.end(),
+                   word_checker)) {
+            std::vector<std::string_view> empty;
+            return { empty, document_it->second.status };
+        }
+
+        std::vector<std::string_view> matched_words(query.plus_words.size());
+        auto words_end = copy_if(exec_policy,
+                                 query.plus_words.begin(), query.plus_words.end(),
+                                 matched_words.begin(),
+                                 word_checker
+        );
+        sort(exec_policy, matched_words.begin(), words_end);
+        words_end = unique(matched_words.begin(), words_end);
+        matched_words.erase(words_end, matched_words.end());
+
+        return make_tuple(matched_words, document_it->second.status);
+    }
 };
\ No newline at end of file
@@ -0,0 +1,642 @@
+#include "search_server_tests.h"
+
+#include "corpus_generator.h"
+#include "document_reader.h"
+#include "paginator.h"
+#include "profiler.h"
+#include "query_arena.h"
+#include "query_cache.h"
+#include "remove_duplicates.h"
+#include "request_queue.h"
+#include "search_cursor.h"
+#include "search_server.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <execution>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <list>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+vector<int> GetIds(const vector<Document>& documents) {
+    vector<int> ids;
+    for (const Document& document : documents) {
+        ids.push_back(document.id);
+    }
+    return ids;
+}
+
+template <typename Function>
+bool ThrowsInvalidArgument(Function function) {
+    try {
+        function();
+    } catch (const invalid_argument&) {
+        return true;
+    }
+    return false;
+}
+
+//все документы запроса в порядке выдачи курсора
+template <typename RankingPolicy>
+vector<Document> ReadAllPages(SearchCursor<RankingPolicy>& cursor, size_t page_size) {
+    vector<Document> documents;
+    for (const auto& page : PaginateStream(cursor, page_size)) {
+        assert(page.size() <= page_size);
+        documents.insert(documents.end(), page.begin(), page.end());
+    }
+    return documents;
+}
+
+string WriteTempFile(const string& name, const string& content) {
+    const string path = (filesystem::temp_directory_path() / name).string();
+    ofstream out(path, ios::binary);
+    out << content;
+    return path;
+}
+
+void TestRemoveDuplicates() {
+    SearchServer search_server("and"s);
+    search_server.AddDocument(1, "cat dog"s, DocumentStatus::ACTUAL, {1});
+    search_server.AddDocument(2, "dog cat cat"s, DocumentStatus::ACTUAL, {2});
+    search_server.AddDocument(3, "cat and dog"s, DocumentStatus::BANNED, {3});
+    search_server.AddDocument(4, "cat bird"s, DocumentStatus::ACTUAL, {4});
+    const vector<int> removed = RemoveDuplicates(search_server);
+    //стоп-слова и частоты слов не важны, остаётся документ с наименьшим id
+    assert((removed == vector<int>{2, 3}));
+    assert((vector<int>(search_server.begin(), search_server.end()) == vector<int>{1, 4}));
+    assert(RemoveDuplicates(search_server).empty());
+}
+
+void TestRemoveNearDuplicates() {
+    string base;
+    for (int i = 0; i < 40; ++i) {
+        base += "w"s + to_string(i) + " "s;
+    }
+    SearchServer search_server("and"s);
+    search_server.AddDocument(1, base, DocumentStatus::ACTUAL, {1});
+    //сходство по Жаккару 40 / 41
+    search_server.AddDocument(2, base + "extra"s, DocumentStatus::ACTUAL, {1});
+    search_server.AddDocument(3, "cat dog bird fish"s, DocumentStatus::ACTUAL, {1});
+    search_server.AddDocument(4, base, DocumentStatus::ACTUAL, {1});
+    assert((RemoveNearDuplicates(search_server, 0.9) == vector<int>{2, 4}));
+    assert(search_server.GetDocumentCount() == 2);
+    assert(ThrowsInvalidArgument([&search_server] { RemoveNearDuplicates(search_server, 0.0); }));
+    assert(ThrowsInvalidArgument([&search_server] { RemoveNearDuplicates(search_server, 1.5); }));
+}
+
+void TestRequestQueue() {
+    SearchServer search_server("and"s);
+    search_server.AddDocument(1, "cat dog"s, DocumentStatus::ACTUAL, {1});
+    search_server.AddDocument(2, "cat bird"s, DocumentStatus::ACTUAL, {2});
+    {
+        RequestQueue request_queue(search_server);
+        request_queue.AddFindRequest("cat"s);
+        request_queue.AddFindRequest("fish"s);
+        request_queue.AddFindRequest("fish"s, DocumentStatus::BANNED);
+        request_queue.AddFindRequest("dog"s, [](int, DocumentStatus, int rating) { return rating > 1; });
+        const RequestStats stats = request_queue.GetStats();
+        assert(stats.requests == 4 && stats.no_result_requests == 3);
+        assert(request_queue.GetNoResultRequests() == 3);
+        assert(stats.result_counts[0] == 3 && stats.result_counts[2] == 1);
+        assert(stats.latency_p50 <= stats.latency_p99 && stats.latency_p99 <= stats.latency_max);
+    }
+    //запросы выходят из окна вместе со своими слотами
+    {
+        RequestQueue request_queue(search_server, chrono::milliseconds(60));
+        request_queue.AddFindRequest("fish"s);
+        assert(request_queue.GetNoResultRequests() == 1);
+        this_thread::sleep_for(chrono::milliseconds(80));
+        assert(request_queue.GetStats().requests == 0);
+    }
+    //одновременные запросы из нескольких потоков не теряются
+    {
+        RequestQueue request_queue(search_server);
+        vector<thread> threads;
+        for (int i = 0; i < 4; ++i) {
+            threads.emplace_back([&request_queue] {
+                for (int j = 0; j < 500; ++j) {
+                    request_queue.AddFindRequest(j % 2 == 0 ? "cat"s : "fish"s);
+                }
+            });
+        }
+        for (thread& worker : threads) {
+            worker.join();
+        }
+        assert(request_queue.GetStats().requests == 2'000 && request_queue.GetNoResultRequests() == 1'000);
+    }
+    //запись в течение нескольких полных оборотов кольца слотов: каждый слот обнуляется заново,
+    //в окне остаются только свежие запросы
+    {
+        const chrono::milliseconds window(60);
+        RequestQueue request_queue(search_server, window);
+        atomic<uint64_t> total_requests = 0;
+        const auto stop_time = chrono::steady_clock::now() + window * 4;
+        vector<thread> threads;
+        for (int i = 0; i < 4; ++i) {
+            threads.emplace_back([&request_queue, &total_requests, stop_time, i] {
+                for (int j = 0; chrono::steady_clock::now() < stop_time; ++j) {
+                    request_queue.AddFindRequest((i + j) % 2 == 0 ? "cat"s : "fish"s);
+                    total_requests.fetch_add(1, memory_order_relaxed);
+                }
+            });
+        }
+        for (thread& worker : threads) {
+            worker.join();
+        }
+        const RequestStats stats = request_queue.GetStats();
+        uint64_t result_count_sum = 0;
+        for (const uint64_t count : stats.result_counts) {
+            result_count_sum += count;
+        }
+        assert(stats.requests == result_count_sum && stats.no_result_requests == stats.result_counts[0]);
+        assert(stats.requests < total_requests.load());
+
+        this_thread::sleep_for(window * 3 / 2);
+        assert(request_queue.GetStats().requests == 0);
+        for (int i = 0; i < 10; ++i) {
+            request_queue.AddFindRequest("fish"s);
+        }
+        assert(request_queue.GetStats().requests == 10 && request_queue.GetNoResultRequests() == 10);
+    }
+}
+
+void TestQueryCache() {
+    SearchServer search_server("and"s);
+    search_server.AddDocument(1, "cat dog"s, DocumentStatus::ACTUAL, {1});
+    search_server.AddDocument(2, "cat bird"s, DocumentStatus::ACTUAL, {2});
+    QueryCache cache(search_server, 100, 4);
+    assert((GetIds(cache.FindTopDocuments("cat -bird"s)) == vector<int>{1}));
+    assert(cache.GetHits() == 0 && cache.GetMisses() == 1);
+    //запросы с одной канонической записью делят запись кеша
+    assert((GetIds(cache.FindTopDocuments("-bird cat cat and"s)) == vector<int>{1}));
+    assert(cache.GetHits() == 1 && cache.GetMisses() == 1);
+    //статус входит в ключ
+    assert(cache.FindTopDocuments("cat -bird"s, DocumentStatus::BANNED).empty());
+    assert(cache.GetMisses() == 2);
+
+    //изменение индекса делает записи устаревшими
+    const uint64_t version = search_server.GetIndexVersion();
+    search_server.AddDocument(3, "cat fish"s, DocumentStatus::ACTUAL, {3});
+    assert(search_server.GetIndexVersion() > version);
+    assert((GetIds(cache.FindTopDocuments("cat -bird"s)) == vector<int>{3, 1}));
+    assert(cache.GetMisses() == 3);
+    search_server.RemoveDocument(3);
+    assert((GetIds(cache.FindTopDocuments("cat -bird"s)) == vector<int>{1}));
+    assert(cache.GetMisses() == 4);
+
+    //очередь запросов поверх кеша обслуживает запросы по статусу через кеш
+    RequestQueue request_queue(cache);
+    request_queue.AddFindRequest("cat -bird"s);
+    request_queue.AddFindRequest("cat -bird"s);
+    assert(cache.GetHits() == 3 && cache.GetMisses() == 4);
+    assert(request_queue.GetStats().requests == 2);
+    assert(&cache.GetSearchServer() == &search_server);
+}
+
+//источник страниц для StreamPaginator: числа от 0 до count
+struct CountingSource {
+    int next = 0;
+    int count = 0;
+    int fetches = 0;
+
+    vector<int> NextPage(size_t page_size) {
+        ++fetches;
+        vector<int> page;
+        for (; next < count && page.size() < page_size; ++next) {
+            page.push_back(next);
+        }
+        return page;
+    }
+};
+
+void TestPaginator() {
+    const vector<int> numbers = {1, 2, 3, 4, 5, 6, 7};
+    const auto pages = Paginate(numbers, 3);
+    assert(pages.size() == 3);
+    vector<size_t> sizes;
+    for (const auto& page : pages) {
+        sizes.push_back(page.size());
+    }
+    assert((sizes == vector<size_t>{3, 3, 1}));
+    assert(*pages[1].begin() == 4 && pages[2].size() == 1 && pages[5].size() == 0);
+
+    //однонаправленные итераторы
+    const list<int> values(numbers.begin(), numbers.end());
+    const auto list_pages = Paginate(values, 2);
+    assert(list_pages.size() == 4);
+    assert(*list_pages.GetPage(3).begin() == 7 && list_pages.GetPage(3).size() == 1);
+    ostringstream out;
+    out << list_pages[1];
+    assert(out.str() == "34"s);
+
+    //указатели и массивы: std::distance и std::begin не находятся поиском по аргументам
+    const int array[] = {1, 2, 3, 4, 5};
+    const auto array_pages = Paginate(array, 2);
+    assert(array_pages.size() == 3 && array_pages[2].size() == 1 && *array_pages[2].begin() == 5);
+    const auto pointer_pages = Paginator(numbers.data(), numbers.data() + numbers.size(), 4);
+    assert(pointer_pages.size() == 2 && pointer_pages[1].size() == 3);
+
+    //нулевой размер страницы считается единицей
+    assert(Paginate(numbers, 0).size() == numbers.size());
+
+    //следующая страница запрашивается у источника только при переходе к ней
+    CountingSource source{ 0, 7, 0 };
+    auto stream = PaginateStream(source, 3);
+    auto it = stream.begin();
+    assert(source.fetches == 1 && it->size() == 3);
+    ++it;
+    assert(source.fetches == 2 && (*it)[0] == 3);
+    ++it;
+    assert(it->size() == 1);
+    ++it;
+    assert(it == stream.end() && source.fetches == 4);
+}
+
+SearchServer MakeCursorServer() {
+    SearchServer search_server("and"s);
+    for (int id = 0; id < 23; ++id) {
+        const string text = id % 3 != 0 ? "cat dog"s : (id % 2 != 0 ? "cat bird bird fish"s : "cat bird"s);
+        search_server.AddDocument(id, text, DocumentStatus::ACTUAL, {id % 5});
+    }
+    search_server.AddDocument(100, "cat bird"s, DocumentStatus::BANNED, {1});
+    return search_server;
+}
+
+void TestSearchCursor() {
+    const SearchServer search_server = MakeCursorServer();
+    SearchCursor cursor(search_server, "cat bird"s);
+    const vector<Document> documents = ReadAllPages(cursor, 4);
+    assert(documents.size() == 23 && cursor.IsExhausted());
+    assert(cursor.NextPage(4).empty());
+    //каждый документ ровно один раз
+    set<int> unique_ids;
+    for (const Document& document : documents) {
+        unique_ids.insert(document.id);
+    }
+    assert(unique_ids.size() == 23 && unique_ids.count(100) == 0);
+    //выдача совпадает с FindTopDocuments, включая порядок документов с равной релевантностью и рейтингом:
+    //FindTopDocuments без уже выданных документов возвращает следующие документы курсора
+    vector<int> expected_ids;
+    while (expected_ids.size() < documents.size()) {
+        const vector<Document> top = search_server.FindTopDocuments("cat bird"s, [&expected_ids](int document_id, DocumentStatus status, int) {
+            return status == DocumentStatus::ACTUAL && count(expected_ids.begin(), expected_ids.end(), document_id) == 0;
+        });
+        assert(!top.empty());
+        for (const Document& document : top) {
+            expected_ids.push_back(document.id);
+        }
+    }
+    assert(GetIds(documents) == expected_ids);
+    for (const size_t page_size : {1, 3, 5, 23, 100}) {
+        SearchCursor paged(search_server, "cat bird"s);
+        assert(GetIds(ReadAllPages(paged, page_size)) == expected_ids);
+    }
+
+    //курсор, восстановленный по последнему документу, продолжает выдачу
+    SearchCursor first_pages(search_server, "cat bird"s);
+    first_pages.NextPage(5);
+    first_pages.NextPage(5);
+    SearchCursor resumed(search_server, "cat bird"s, DocumentStatus::ACTUAL, first_pages.GetLastDocument());
+    const vector<Document> rest = ReadAllPages(resumed, 6);
+    assert((GetIds(rest) == GetIds(vector<Document>(documents.begin() + 10, documents.end()))));
+
+    //после изменения индекса выдача продолжается по новому индексу без повторов
+    SearchServer changing_server = MakeCursorServer();
+    SearchCursor changing(changing_server, "cat bird"s);
+    const vector<Document> first_page = changing.NextPage(10);
+    changing_server.RemoveDocument(expected_ids[15]);
+    //cat есть во всех документах, поэтому новый документ с наименьшим рейтингом окажется последним
+    changing_server.AddDocument(50, "cat"s, DocumentStatus::ACTUAL, {-1});
+    const vector<int> changed_rest = GetIds(ReadAllPages(changing, 4));
+    assert(changed_rest.size() == 13 && changed_rest.back() == 50);
+    assert(count(changed_rest.begin(), changed_rest.end(), expected_ids[15]) == 0);
+    for (const Document& document : first_page) {
+        assert(count(changed_rest.begin(), changed_rest.end(), document.id) == 0);
+    }
+
+    //статус курсора
+    SearchCursor banned(search_server, "cat"s, DocumentStatus::BANNED);
+    assert((GetIds(banned.NextPage(10)) == vector<int>{100}) && banned.IsExhausted());
+
+    //запрос разбирается при создании курсора
+    assert(ThrowsInvalidArgument([&search_server] { SearchCursor cursor(search_server, "cat --dog"s); }));
+}
+
+void ProfiledOuter() {
+    PROFILE_SCOPE("TestOuter");
+    PROFILE_SCOPE("TestInner");
+}
+
+void TestProfiler() {
+    Profiler::Flush();
+    ProfiledOuter();
+    //выключенный профилировщик не пишет события
+    assert(Profiler::Flush().GetEvents().empty());
+
+    Profiler::Enable();
+    ProfiledOuter();
+    ProfiledOuter();
+    const ProfileReport report = Profiler::Flush();
+    assert(report.GetEvents().size() == 4 && report.GetDroppedEventCount() == 0);
+    const auto stats = report.Aggregate();
+    const auto inner = find_if(stats.begin(), stats.end(),
+                               [](const ProfileScopeStats& scope) { return scope.path == "TestOuter/TestInner"s; });
+    assert(inner != stats.end() && inner->count == 2 && inner->p50 <= inner->max);
+    ostringstream trace;
+    report.WriteChromeTrace(trace);
+    assert(trace.str().find("\"path\":\"TestOuter/TestInner\""s) != string::npos);
+
+    //буфер завершившегося потока достаётся следующему
+    for (int i = 0; i < 20; ++i) {
+        thread(ProfiledOuter).join();
+    }
+    const ProfileReport threads_report = Profiler::Flush();
+    assert(threads_report.GetEvents().size() == 40);
+    for (const ProfileEvent& event : threads_report.GetEvents()) {
+        assert(event.thread_id == threads_report.GetEvents().front().thread_id);
+    }
+
+    //переполненный буфер отбрасывает события и сообщает о них
+    for (size_t i = 0; i < Profiler::MAX_BUFFERED_EVENTS + 3; ++i) {
+        PROFILE_SCOPE("TestHot");
+    }
+    const ProfileReport dropped_report = Profiler::Flush();
+    assert(dropped_report.GetEvents().size() == Profiler::MAX_BUFFERED_EVENTS);
+    assert(dropped_report.GetDroppedEventCount() == 3);
+    ostringstream dropped_trace;
+    dropped_report.WriteChromeTrace(dropped_trace);
+    assert(dropped_trace.str().find("\"dropped_events\":3"s) != string::npos);
+    Profiler::Enable(false);
+}
+
+void TestQueryStats() {
+    SearchServer search_server("and"s);
+    search_server.AddDocument(1, "cat dog"s, DocumentStatus::ACTUAL, {1});
+    search_server.AddDocument(2, "cat bird"s, DocumentStatus::ACTUAL, {2});
+    search_server.AddDocument(3, "fish"s, DocumentStatus::ACTUAL, {3});
+    const auto [documents, stats] = search_server.FindTopDocumentsWithStats(execution::seq, "cat -bird"s);
+    assert((GetIds(documents) == vector<int>{1}));
+    //найденные слова ссылаются на строку запроса
+    const string query = "cat -bird"s;
+    const auto [match, match_stats] = search_server.MatchDocumentWithStats(query, 1);
+    assert((get<0>(match) == vector<string_view>{"cat"sv}));
+    if constexpr (COLLECT_SEARCH_STATS) {
+        //списки документов слов cat и bird
+        assert(stats.postings_scanned == 3);
+        assert(stats.documents_scored == 1 && stats.minus_filtered == 1);
+        assert(stats.map_lookups > 0 && match_stats.map_lookups > 0);
+        assert(search_server.GetIndexStats().allocations > 0);
+    } else {
+        assert(stats.postings_scanned == 0 && stats.map_lookups == 0);
+    }
+}
+
+void TestCorpusGenerator() {
+    CorpusConfig config;
+    config.vocabulary_size = 500;
+    config.median_document_words = 20;
+    CorpusGenerator first(config, 7);
+    CorpusGenerator second(config, 7);
+    assert(first.GetVocabulary() == second.GetVocabulary());
+    assert(set<string>(first.GetVocabulary().begin(), first.GetVocabulary().end()).size() == 500);
+
+    //одинаковое зерно - одинаковый корпус
+    vector<string> texts;
+    first.Generate(50, 10, [&texts](int document_id, string_view text, DocumentStatus, const vector<int>& ratings) {
+        assert(document_id >= 10 && document_id < 60 && ratings.size() <= 5);
+        texts.emplace_back(text);
+    });
+    size_t index = 0;
+    second.Generate(50, 10, [&texts, &index](int, string_view text, DocumentStatus, const vector<int>&) {
+        assert(texts[index++] == text);
+    });
+
+    SearchServer search_server("and"s);
+    first.FeedDocuments(search_server, 100, 1'000);
+    assert(search_server.GetDocumentCount() == 100 && *search_server.begin() == 1'000);
+
+    //по Ципфу первые номера встречаются чаще
+    mt19937 generator(1);
+    const ZipfDistribution zipf(100, 1.0);
+    vector<int> counts(100);
+    for (int i = 0; i < 10'000; ++i) {
+        const size_t rank = zipf(generator);
+        assert(rank < 100);
+        ++counts[rank];
+    }
+    assert(counts[0] > counts[10] && counts[10] > counts[99]);
+    const ZipfDistribution single(1, 2.0);
+    assert(single(generator) == 0);
+    assert(ThrowsInvalidArgument([] { ZipfDistribution(0, 1.0); }));
+    assert(ThrowsInvalidArgument([] { ZipfDistribution(10, numeric_limits<double>::quiet_NaN()); }));
+    assert(ThrowsInvalidArgument([] { ZipfDistribution(10, numeric_limits<double>::infinity()); }));
+    CorpusConfig empty_config;
+    empty_config.vocabulary_size = 0;
+    assert(ThrowsInvalidArgument([&empty_config] { CorpusGenerator(empty_config, 1); }));
+
+    QueryLogConfig log_config;
+    log_config.hot_query_count = 10;
+    log_config.hot_query_share = 1.0;
+    QueryLogGenerator query_log(first, log_config, 3);
+    const vector<string> queries = query_log.Generate(200);
+    assert(queries.size() == 200 && set<string>(queries.begin(), queries.end()).size() <= 10);
+}
+
+void TestDocumentReader() {
+    const string tsv_path = WriteTempFile("search_server_test.tsv"s,
+                                          "1\tACTUAL\t1 2 3\tcurly cat curly tail\n"s
+                                          "2\t1\t\tcurly dog and fancy collar\r\n"s
+                                          "\n"s
+                                          "3\tBANNED\t5,6\tbig cat\n"s);
+    SearchServer tsv_server("and"s);
+    assert(LoadDocuments(tsv_server, tsv_path, DocumentFileFormat::TSV, 2) == 3);
+    assert((GetIds(tsv_server.FindTopDocuments("curly"s, DocumentStatus::IRRELEVANT)) == vector<int>{2}));
+    assert(tsv_server.FindTopDocuments("cat"s, DocumentStatus::BANNED).front().rating == 5);
+    assert(tsv_server.FindTopDocuments("cat"s).front().rating == 2);
+
+    const string jsonl_path = WriteTempFile("search_server_test.jsonl"s,
+                                            "{\"id\": 1, \"status\": \"ACTUAL\", \"ratings\": [1, 2], \"text\": \"curly cat\"}\n"s
+                                            "{\"text\":\"big \\\"dog\\\" caf\\u00e9 \\ud83d\\ude00\",\"extra\":[1,\"x\"],\"id\":2,\"status\":2,\"ratings\":[]}\n"s);
+    SearchServer jsonl_server("and"s);
+    assert(LoadDocuments(jsonl_server, jsonl_path, DocumentFileFormat::JSONL) == 2);
+    set<string> words;
+    for (const auto& [word, frequency] : jsonl_server.GetWordFrequencies(2)) {
+        words.emplace(word);
+    }
+    //é - двухбайтовый UTF-8, пара суррогатов - один четырёхбайтовый символ
+    assert((words == set<string>{"\"dog\""s, "big"s, "caf\xC3\xA9"s, "\xF0\x9F\x98\x80"s}));
+
+    //переводы строк и табуляции внутри текста разделяют слова
+    const string escapes_path = WriteTempFile("search_server_test_escapes.jsonl"s,
+                                              "{\"id\": 3, \"text\": \"big\\ncat\\t\\tdog\\r\\nfish\\u0007bird\"}\n"s);
+    SearchServer escapes_server("and"s);
+    assert(LoadDocuments(escapes_server, escapes_path, DocumentFileFormat::JSONL) == 1);
+    words.clear();
+    for (const auto& [word, frequency] : escapes_server.GetWordFrequencies(3)) {
+        words.emplace(word);
+    }
+    assert((words == set<string>{"big"s, "bird"s, "cat"s, "dog"s, "fish"s}));
+    assert((GetIds(escapes_server.FindTopDocuments("dog"s)) == vector<int>{3}));
+    remove(escapes_path.c_str());
+
+    //ошибки разбора сообщают номер строки
+    const auto load_error = [](const string& name, const string& content, DocumentFileFormat format) {
+        const string path = WriteTempFile(name, content);
+        SearchServer search_server("and"s);
+        try {
+            LoadDocuments(search_server, path, format);
+        } catch (const invalid_argument& e) {
+            remove(path.c_str());
+            return string(e.what());
+        }
+        remove(path.c_str());
+        return ""s;
+    };
+    assert(load_error("bad.tsv"s, "1\tACTUAL\t1\tok\nx\tACTUAL\t\tbad\n"s, DocumentFileFormat::TSV).find("Line 2"s) != string::npos);
+    const auto json_error = [&load_error](const string& text) {
+        return load_error("bad.jsonl"s, "{\"id\": 1, \"text\": \""s + text + "\"}\n"s, DocumentFileFormat::JSONL);
+    };
+    assert(json_error("x\\uzzzz"s).find("Invalid JSON escape"s) != string::npos);
+    assert(json_error("x\\u12"s).find("Invalid JSON escape"s) != string::npos);
+    assert(json_error("x\\ud83d"s).find("Invalid JSON surrogate pair"s) != string::npos);
+    assert(json_error("x\\ude00"s).find("Invalid JSON surrogate pair"s) != string::npos);
+    assert(load_error("bad.jsonl"s, "{\"id\": 1, \"text\": \"abc\\"s, DocumentFileFormat::JSONL)
+                   .find("Unterminated JSON string"s) != string::npos);
+    remove(tsv_path.c_str());
+    remove(jsonl_path.c_str());
+}
+
+void TestQueryArena() {
+    QueryArena arena(1'024);
+    {
+        pmr::vector<int> values(&arena);
+        values.resize(10'000);
+        assert(arena.GetCapacity() >= 40'000);
+    }
+    //после сброса остаётся только последний блок
+    const size_t capacity = arena.GetCapacity();
+    arena.Reset();
+    assert(arena.GetCapacity() > 0 && arena.GetCapacity() <= capacity);
+    {
+        pmr::vector<int> values(&arena);
+        values.resize(100);
+        assert(arena.GetCapacity() <= capacity);
+    }
+
+    assert(QueryArenaScope::GetResource() == pmr::get_default_resource());
+    {
+        QueryArenaScope scope;
+        pmr::memory_resource* const resource = QueryArenaScope::GetResource();
+        assert(resource != pmr::get_default_resource());
+        QueryArenaScope nested;
+        assert(QueryArenaScope::GetResource() == resource);
+    }
+    assert(QueryArenaScope::GetResource() == pmr::get_default_resource());
+
+    //результаты не зависят от переиспользования арены и пула индекса
+    SearchServer search_server("and"s);
+    CorpusConfig config;
+    config.vocabulary_size = 300;
+    config.median_document_words = 15;
+    CorpusGenerator corpus(config, 11);
+    corpus.FeedDocuments(search_server, 300);
+    QueryLogGenerator query_log(corpus, QueryLogConfig{}, 5);
+    const vector<string> queries = query_log.Generate(50);
+    vector<vector<int>> first;
+    for (const string& query : queries) {
+        first.push_back(GetIds(search_server.FindTopDocuments(query)));
+    }
+    for (int id = 0; id < 300; id += 2) {
+        search_server.RemoveDocument(id);
+    }
+    for (size_t i = 0; i < queries.size(); ++i) {
+        const vector<int> ids = GetIds(search_server.FindTopDocuments(execution::par, queries[i]));
+        assert(all_of(ids.begin(), ids.end(), [](int id) { return id % 2 == 1; }));
+        assert(ids.size() <= first[i].size() || first[i].size() == MAX_RESULT_DOCUMENT_COUNT);
+    }
+}
+
+void TestRanking() {
+    SearchServer search_server("and"s);
+    search_server.AddDocument(1, "cat dog"s, DocumentStatus::ACTUAL, {1});
+    search_server.AddDocument(2, "bird"s, DocumentStatus::ACTUAL, {1});
+    //TF-IDF: tf * log(N / df)
+    const vector<Document> tf_idf = search_server.FindTopDocuments("cat"s);
+    assert(tf_idf.size() == 1 && abs(tf_idf[0].relevance - 0.5 * log(2.0)) < 1e-9);
+    assert(abs(search_server.GetAverageDocumentLength() - 1.5) < 1e-9);
+
+    //BM25 учитывает число вхождений и длину документа: документ 3 выше, хотя tf у документов 3 и 4 равны
+    SearchServer bm25_server("and"s);
+    bm25_server.AddDocument(3, "cat cat cat cat dog dog dog dog"s, DocumentStatus::ACTUAL, {1});
+    bm25_server.AddDocument(4, "cat dog"s, DocumentStatus::ACTUAL, {5});
+    bm25_server.AddDocument(5, "bird"s, DocumentStatus::ACTUAL, {1});
+    assert((GetIds(bm25_server.FindTopDocuments("cat"s)) == vector<int>{4, 3}));
+    const vector<Document> bm25 = bm25_server.FindTopDocuments(execution::seq, "cat"s, DocumentStatus::ACTUAL, Bm25Ranking{});
+    assert((GetIds(bm25) == vector<int>{3, 4}));
+    assert((GetIds(bm25_server.FindTopDocuments(execution::par, "cat"s, DocumentStatus::ACTUAL, Bm25Ranking{})) == vector<int>{3, 4}));
+    bm25_server.RemoveDocument(5);
+    assert(abs(bm25_server.GetAverageDocumentLength() - 5.0) < 1e-9);
+
+    //политика ранжирования доходит до постраничной выдачи и счётчиков
+    SearchCursor cursor(bm25_server, "cat"s, DocumentStatus::ACTUAL, nullopt, Bm25Ranking{});
+    assert((GetIds(ReadAllPages(cursor, 1)) == vector<int>{3, 4}));
+    assert((GetIds(bm25_server.FindTopDocumentsAfter(execution::seq, "cat"s, StatusFilter{}, nullopt, 1, Bm25Ranking{})) == vector<int>{3}));
+    const auto [documents, stats] = bm25_server.FindTopDocumentsWithStats(execution::seq, "cat"s, DocumentStatus::ACTUAL, Bm25Ranking{});
+    assert((GetIds(documents) == vector<int>{3, 4}));
+}
+
+void TestStatusBitmaps() {
+    //id больше MAX_STATUS_BITMAP_SIZE проверяются через данные документа
+    SearchServer search_server("and"s);
+    search_server.AddDocument(1, "cat"s, DocumentStatus::ACTUAL, {1});
+    search_server.AddDocument(2, "cat"s, DocumentStatus::BANNED, {2});
+    search_server.AddDocument(20'000'000, "cat"s, DocumentStatus::BANNED, {3});
+    search_server.AddDocument(20'000'001, "cat"s, DocumentStatus::ACTUAL, {4});
+    assert((GetIds(search_server.FindTopDocuments("cat"s)) == vector<int>{20'000'001, 1}));
+    assert((GetIds(search_server.FindTopDocuments("cat"s, DocumentStatus::BANNED)) == vector<int>{20'000'000, 2}));
+    assert(search_server.FindTopDocuments("cat"s, DocumentStatus::REMOVED).empty());
+
+    search_server.RemoveDocument(2);
+    search_server.RemoveDocument(execution::par, 20'000'000);
+    assert(search_server.FindTopDocuments(execution::par, "cat"s, DocumentStatus::BANNED).empty());
+    //после удаления id можно занять с другим статусом
+    search_server.AddDocument(2, "cat"s, DocumentStatus::IRRELEVANT, {2});
+    assert((GetIds(search_server.FindTopDocuments("cat"s, DocumentStatus::IRRELEVANT)) == vector<int>{2}));
+    //произвольный предикат видит тот же статус
+    assert((GetIds(search_server.FindTopDocuments("cat"s, [](int, DocumentStatus status, int) {
+        return status == DocumentStatus::IRRELEVANT;
+    })) == vector<int>{2}));
+}
+
+}
+
+void TestSearchServer() {
+    TestRemoveDuplicates();
+    TestRemoveNearDuplicates();
+    TestRequestQueue();
+    TestQueryCache();
+    TestPaginator();
+    TestSearchCursor();
+    TestProfiler();
+    TestQueryStats();
+    TestCorpusGenerator();
+    TestDocumentReader();
+    TestQueryArena();
+    TestRanking();
+    TestStatusBitmaps();
+}
@@ -0,0 +1,5 @@
+#pragma once
+
+//Проверки поведения SearchServer и модулей вокруг него (assert).
+//Запускаются из main до замеров; при NDEBUG ничего не проверяют
+void TestSearchServer();
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <type_traits>
+
+//Счётчики стоимости запроса на горячих путях индекса.
+//Сбор включается на этапе компиляции: при SEARCH_SERVER_COLLECT_STATS=0 StatsRecorder<COLLECT_SEARCH_STATS>
+//становится пустым классом, а все вызовы Add - пустыми функциями
+
+#ifndef SEARCH_SERVER_COLLECT_STATS
+#define SEARCH_SERVER_COLLECT_STATS 1
+#endif
+
+inline constexpr bool COLLECT_SEARCH_STATS = SEARCH_SERVER_COLLECT_STATS != 0;
+
+struct QueryStats {
+    uint64_t postings_scanned = 0;   //просмотренные элементы списков документов слов
+    uint64_t documents_scored = 0;   //начисления релевантности документам
+    uint64_t minus_filtered = 0;     //документы, отброшенные минус-словами
+    uint64_t map_lookups = 0;        //поиски в словарях индекса
+    uint64_t lock_acquisitions = 0;  //захваты мьютексов
+    uint64_t lock_waits = 0;         //захваты, которым пришлось ждать освобождения мьютекса
+    uint64_t allocations = 0;        //узлы, выделенные во временных структурах запроса или в индексе
+};
+
+enum class StatsCounter {
+    POSTINGS_SCANNED,
+    DOCUMENTS_SCORED,
+    MINUS_FILTERED,
+    MAP_LOOKUPS,
+    LOCK_ACQUISITIONS,
+    LOCK_WAITS,
+    ALLOCATIONS,
+    COUNT,
+};
+
+//Потокобезопасный накопитель счётчиков одного запроса
+template <bool Enabled>
+class StatsRecorder {
+public:
+    static constexpr bool ENABLED = Enabled;
+
+    void Add(StatsCounter counter, uint64_t value = 1) {
+        if constexpr (Enabled) {
+            counters_[static_cast<size_t>(counter)].fetch_add(value, std::memory_order_relaxed);
+        }
+    }
+
+    [[nodiscard]] QueryStats GetStats() const {
+        QueryStats stats;
+        if constexpr (Enabled) {
+            stats.postings_scanned = Get(StatsCounter::POSTINGS_SCANNED);
+            stats.documents_scored = Get(StatsCounter::DOCUMENTS_SCORED);
+            stats.minus_filtered = Get(StatsCounter::MINUS_FILTERED);
+            stats.map_lookups = Get(StatsCounter::MAP_LOOKUPS);
+            stats.lock_acquisitions = Get(StatsCounter::LOCK_ACQUISITIONS);
+            stats.lock_waits = Get(StatsCounter::LOCK_WAITS);
+            stats.allocations = Get(StatsCounter::ALLOCATIONS);
+        }
+        return stats;
+    }
+
+private:
+    struct Disabled {};
+    std::conditional_t<Enabled,
+            std::array<std::atomic<uint64_t>, static_cast<size_t>(StatsCounter::COUNT)>,
+            Disabled> counters_{};
+
+    [[nodiscard]] uint64_t Get(StatsCounter counter) const {
+        return counters_[static_cast<size_t>(counter)].load(std::memory_order_relaxed);
+    }
+};
+
+//Счётчики для путей, где сбор не запрошен: всегда компилируются в пустой код
+using NoStatsRecorder = StatsRecorder<false>;
+
+//Захватывает мьютекс, учитывая захват и ожидание в recorder
+template <typename Recorder>
+void LockCounted(std::mutex& mutex, Recorder& recorder) {
+    if constexpr (Recorder::ENABLED) {
+        recorder.Add(StatsCounter::LOCK_ACQUISITIONS);
+        if (!mutex.try_lock()) {
+            recorder.Add(StatsCounter::LOCK_WAITS);
+            mutex.lock();
+        }
+    } else {
+        mutex.lock();
+    }
+}
+
+//Накопление счётчиков в однопоточном коде изменения индекса
+inline void AddStat(QueryStats& stats, uint64_t QueryStats::* counter, uint64_t value = 1) {
+    if constexpr (COLLECT_SEARCH_STATS) {
+        stats.*counter += value;
+    }
+}
\ No newline at end of file
@@ -1,7 +1,9 @@
 #include "string_processing.h"
 
-VectorStringView SplitIntoWords(std::string_view str) {
-    VectorStringView result;
+namespace {
+
+template <typename Words>
+void AppendWords(std::string_view str, Words& result) {
     while (true) {
         const auto space = str.find(' ');
         result.push_back(str.substr(0, space));
@@ -11,5 +13,18 @@ VectorStringView SplitIntoWords(std::string_view str) {
             str.remove_prefix(space + 1);
         }
     }
+}
+
+}
+
+VectorStringView SplitIntoWords(std::string_view str) {
+    VectorStringView result;
+    AppendWords(str, result);
+    return result;
+}
+
+std::pmr::vector<std::string_view> SplitIntoWords(std::string_view str, std::pmr::memory_resource* resource) {
+    std::pmr::vector<std::string_view> result(resource);
+    AppendWords(str, result);
     return result;
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <iostream>
+#include <memory_resource>
 #include <set>
 #include <string>
 #include <string_view>
@@ -13,6 +14,8 @@ using SetString = std::set<std::string, std::less<>>;
 using VectorStringView = std::vector<std::string_view>;
 
 VectorStringView SplitIntoWords(std::string_view text);
+//то же, но вектор слов размещается в resource (арене запроса)
+std::pmr::vector<std::string_view> SplitIntoWords(std::string_view text, std::pmr::memory_resource* resource);
 
 //шаблонные функции
 template <typename StringContainer>
@@ -2,9 +2,19 @@
 #include <cstddef>
 #include <utility>
 #include <iterator>
+#include <memory>
+#include <new>
 #include <vector>
 #include <iostream>
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
 
 template<typename Type>
 class SingleLinkedList {
@@ -17,12 +27,65 @@ class SingleLinkedList {
 
         }
 
+        Node(Type &&val, Node *next)
+                : value(std::move(val)), next_node(next) {
+
+        }
+
         Type value;
         Node *next_node = nullptr;
     };
 
 public:
 
+    // Пул памяти под узлы: освобождённые узлы попадают в список свободных и переиспользуются,
+    // новые нарезаются из блоков, каждый следующий блок вдвое больше предыдущего.
+    // Память блоков возвращается системе только при уничтожении пула.
+    // Пул может быть общим для нескольких списков (через shared_ptr), тогда между ними
+    // SpliceAfter перевешивает узлы без копирования. Пул не потокобезопасен
+    class NodePool {
+    public:
+        NodePool() = default;
+
+        NodePool(const NodePool &) = delete;
+
+        NodePool &operator=(const NodePool &) = delete;
+
+        void *Allocate() {
+            if (free_slots_ != nullptr) {
+                return std::exchange(free_slots_, free_slots_->next);
+            }
+            if (chunk_rest_ == 0) {
+                chunks_.emplace_back(new Slot[next_chunk_size_]);
+                chunk_rest_ = next_chunk_size_;
+                next_chunk_size_ = std::min(next_chunk_size_ * 2, MAX_CHUNK_SIZE);
+            }
+            --chunk_rest_;
+            return &chunks_.back()[chunk_rest_];
+        }
+
+        void Deallocate(void *node) noexcept {
+            Slot *slot = static_cast<Slot *>(node);
+            slot->next = free_slots_;
+            free_slots_ = slot;
+        }
+
+    private:
+        static constexpr size_t FIRST_CHUNK_SIZE = 16;
+        static constexpr size_t MAX_CHUNK_SIZE = 1 << 16;
+
+        // Ячейка под узел; пока ячейка свободна, в ней хранится ссылка на следующую свободную
+        union Slot {
+            Slot *next;
+            alignas(Node) unsigned char storage[sizeof(Node)];
+        };
+
+        std::vector<std::unique_ptr<Slot[]>> chunks_;
+        Slot *free_slots_ = nullptr;
+        size_t chunk_rest_ = 0;
+        size_t next_chunk_size_ = FIRST_CHUNK_SIZE;
+    };
+
     template<typename ValueType>
     class BasicIterator {
 
@@ -99,6 +162,9 @@ public:
     using reference = value_type &;
     using const_reference = const value_type &;
 
+    // Память под один узел в байтах
+    static constexpr size_t NODE_SIZE = sizeof(Node);
+
     // Итератор, допускающий изменение элементов списка
     using Iterator = BasicIterator<Type>;
     // Константный итератор, предоставляющий доступ для чтения к элементам списка
@@ -109,24 +175,26 @@ public:
             size_(0) {
     }
 
+    // Список, берущий узлы из общего пула pool
+    explicit SingleLinkedList(std::shared_ptr<NodePool> pool) :
+            pool_(std::move(pool)) {
+        assert(pool_ != nullptr);
+    }
+
     SingleLinkedList(std::initializer_list<Type> values) {
-        SingleLinkedList tmp;
-        for (auto it = std::rbegin(values); it != std::rend(values); ++it) {
-            tmp.PushFront(*it);
-        }
-        swap(tmp);
+        InsertAfter(before_begin(), values.begin(), values.end());
     }
 
+    // Копия получает собственный пул и заполняется за один проход по other
     SingleLinkedList(const SingleLinkedList &other) {
-        SingleLinkedList tmp;
-        std::vector<Type> tmp_vector;
-        for (const auto &value : other) {
-            tmp_vector.push_back(value);
-        }
-        for (auto it = std::rbegin(tmp_vector); it != std::rend(tmp_vector); ++it) {
-            tmp.PushFront(*it);
-        }
-        swap(tmp);
+        InsertAfter(before_begin(), other.begin(), other.end());
+    }
+
+    // Узлы вместе с их пулом переходят к новому списку, other остаётся пустым
+    SingleLinkedList(SingleLinkedList &&other) noexcept(std::is_nothrow_default_constructible_v<Type>) :
+            size_(std::exchange(other.size_, 0)),
+            pool_(std::move(other.pool_)) {
+        head_.next_node = std::exchange(other.head_.next_node, nullptr);
     }
 
 
@@ -176,29 +244,42 @@ public:
     }
 
     void PushFront(const Type &value) {
-        head_.next_node = new Node(value, head_.next_node);
+        head_.next_node = CreateNode(value, head_.next_node);
         ++size_;
     }
 
     // Очищает список за время O(N)
     void Clear() noexcept {
-        while (head_.next_node != nullptr) {
-            Node *new_head = head_.next_node->next_node;
-            delete head_.next_node;
-            head_.next_node = new_head;
-            --this->size_;
-        }
+        DestroyChain(std::exchange(head_.next_node, nullptr));
+        size_ = 0;
     }
 
     void swap(SingleLinkedList &other) noexcept {
         std::swap(this->size_, other.size_);
         std::swap(this->head_.next_node, other.head_.next_node);
+        std::swap(this->pool_, other.pool_);
+    }
+
+    [[nodiscard]] const std::shared_ptr<NodePool> &GetPool() {
+        return Pool();
     }
 
+    // Копия строится в узлах пула этого списка, затем обмениваются только цепочки узлов:
+    // список, получивший общий пул, остаётся в нём. При исключении список не меняется
     SingleLinkedList &operator=(const SingleLinkedList &rhs) {
         if (this != &rhs) {
-            SingleLinkedList tmp(rhs);
-            swap(tmp);
+            SingleLinkedList tmp(Pool());
+            tmp.InsertAfter(tmp.before_begin(), rhs.begin(), rhs.end());
+            std::swap(head_.next_node, tmp.head_.next_node);
+            std::swap(size_, tmp.size_);
+        }
+        return *this;
+    }
+
+    SingleLinkedList &operator=(SingleLinkedList &&rhs) noexcept {
+        if (this != &rhs) {
+            Clear();
+            swap(rhs);
         }
         return *this;
     }
@@ -210,17 +291,98 @@ public:
     Iterator InsertAfter(ConstIterator pos, const Type &value) {
         assert(pos.node_ != nullptr);
         if (pos.node_ != nullptr) {
-            pos.node_->next_node = new Node(value, pos.node_->next_node);
+            pos.node_->next_node = CreateNode(value, pos.node_->next_node);
             ++size_;
             return Iterator{pos.node_->next_node};
         }
         return Iterator{nullptr};
     }
 
+    Iterator InsertAfter(ConstIterator pos, Type &&value) {
+        assert(pos.node_ != nullptr);
+        pos.node_->next_node = CreateNode(std::move(value), pos.node_->next_node);
+        ++size_;
+        return Iterator{pos.node_->next_node};
+    }
+
+    /*
+     * Вставляет элементы [first, last) после pos.
+     * Узлы сначала связываются в отдельную цепочку, поэтому при исключении список не меняется.
+     * Возвращает итератор на последний вставленный элемент (pos, если диапазон пуст)
+     */
+    template<typename InputIterator>
+    Iterator InsertAfter(ConstIterator pos, InputIterator first, InputIterator last) {
+        assert(pos.node_ != nullptr);
+        Node *chain = nullptr;
+        Node **chain_end = &chain;
+        Node *last_node = pos.node_;
+        size_t count = 0;
+        try {
+            for (; first != last; ++first) {
+                last_node = CreateNode(*first, nullptr);
+                *chain_end = last_node;
+                chain_end = &last_node->next_node;
+                ++count;
+            }
+        } catch (...) {
+            DestroyChain(chain);
+            throw;
+        }
+        if (chain != nullptr) {
+            *chain_end = pos.node_->next_node;
+            pos.node_->next_node = chain;
+            size_ += count;
+        }
+        return Iterator{last_node};
+    }
+
+    Iterator InsertAfter(ConstIterator pos, std::initializer_list<Type> values) {
+        return InsertAfter(pos, values.begin(), values.end());
+    }
+
+    /*
+     * Переносит элементы (before_first, last) списка other после pos.
+     * При общем пуле (или если у этого списка ещё нет пула) узлы перевешиваются без копирования,
+     * время - O(длины диапазона) на подсчёт размера. Иначе элементы перемещаются в узлы своего пула:
+     * пустой список с заданным пулом, например общим с другими списками, свой пул не меняет
+     */
+    void SpliceAfter(ConstIterator pos, SingleLinkedList &other, ConstIterator before_first, ConstIterator last) {
+        assert(pos.node_ != nullptr && before_first.node_ != nullptr);
+        if (before_first.node_->next_node == last.node_) {
+            return;
+        }
+        if (pool_ == nullptr && this != &other) {
+            pool_ = other.Pool();
+        }
+        if (pool_ != other.pool_) {
+            InsertAfter(pos, std::make_move_iterator(Iterator{before_first.node_->next_node}),
+                        std::make_move_iterator(Iterator{last.node_}));
+            other.EraseAfter(before_first, last);
+            return;
+        }
+        Node *first_node = before_first.node_->next_node;
+        Node *last_node = first_node;
+        size_t count = 1;
+        for (; last_node->next_node != last.node_; last_node = last_node->next_node) {
+            ++count;
+        }
+        before_first.node_->next_node = last.node_;
+        last_node->next_node = pos.node_->next_node;
+        pos.node_->next_node = first_node;
+        other.size_ -= count;
+        size_ += count;
+    }
+
+    // Переносит все элементы other после pos
+    void SpliceAfter(ConstIterator pos, SingleLinkedList &other) {
+        assert(this != &other);
+        SpliceAfter(pos, other, other.cbefore_begin(), other.cend());
+    }
+
     void PopFront() noexcept {
         assert(head_.next_node != nullptr);
         Node *new_head = head_.next_node->next_node;
-        delete head_.next_node;
+        DestroyNode(head_.next_node);
         head_.next_node = new_head;
         --size_;
     }
@@ -234,15 +396,59 @@ public:
         const Node *new_pos = pos.node_->next_node;
         assert(new_pos != nullptr);
         pos.node_->next_node = new_pos->next_node;
-        delete new_pos;
+        DestroyNode(const_cast<Node *>(new_pos));
         --size_;
         return Iterator{pos.node_->next_node};
     }
 
+    /*
+     * Удаляет элементы (first, last).
+     * Возвращает итератор last
+     */
+    Iterator EraseAfter(ConstIterator first, ConstIterator last) noexcept {
+        assert(first.node_ != nullptr);
+        while (first.node_->next_node != last.node_) {
+            EraseAfter(first);
+        }
+        return Iterator{last.node_};
+    }
+
 private:
 
     Node head_;
     size_t size_ = 0;
+    // Создаётся при первой вставке, если список не получил общий пул
+    std::shared_ptr<NodePool> pool_;
+
+    const std::shared_ptr<NodePool> &Pool() {
+        if (pool_ == nullptr) {
+            pool_ = std::make_shared<NodePool>();
+        }
+        return pool_;
+    }
+
+    template<typename Value>
+    Node *CreateNode(Value &&value, Node *next) {
+        NodePool &pool = *Pool();
+        void *memory = pool.Allocate();
+        try {
+            return new(memory) Node(std::forward<Value>(value), next);
+        } catch (...) {
+            pool.Deallocate(memory);
+            throw;
+        }
+    }
+
+    void DestroyNode(Node *node) noexcept {
+        node->~Node();
+        pool_->Deallocate(node);
+    }
+
+    void DestroyChain(Node *node) noexcept {
+        while (node != nullptr) {
+            DestroyNode(std::exchange(node, node->next_node));
+        }
+    }
 };
 
 template<typename Type>
@@ -281,151 +487,1372 @@ bool operator>=(const SingleLinkedList<Type> &lhs, const SingleLinkedList<Type>
     return !(lhs < rhs);
 }
 
-void Test4() {
-    struct DeletionSpy {
-        ~DeletionSpy() {
-            if (deletion_counter_ptr) {
-                ++(*deletion_counter_ptr);
-            }
+/*
+ * Развёрнутый односвязный список: каждый узел (блок) хранит до CHUNK_CAPACITY элементов подряд,
+ * поэтому обход читает соседние элементы из одной строки кэша, а переход к следующему узлу
+ * нужен раз на блок. Интерфейс повторяет SingleLinkedList.
+ * Блоки не бывают пустыми. Вставка в полный блок делит его пополам; вставка в конец полного блока
+ * идёт в начало следующего блока или в новый блок, так что последовательное заполнение даёт полные блоки.
+ * После удаления блок сливается со следующим, если вместе они занимают не больше половины блока.
+ *
+ * Правила действительности итераторов:
+ *  - before_begin() и end() действительны всегда;
+ *  - InsertAfter делает недействительными итераторы на элементы того блока, куда попал элемент, после места вставки,
+ *    а при делении полного блока - на все элементы его второй половины;
+ *  - EraseAfter делает недействительными итераторы на удалённый элемент и элементы после него в том же блоке,
+ *    а при слиянии блоков - на все элементы следующего блока;
+ *  - итераторы на элементы остальных блоков не меняются.
+ * Элементы переносятся перемещением; строгая гарантия при исключениях - если перемещение Type не выбрасывает
+ */
+template<typename Type, size_t CHUNK_CAPACITY = 16>
+class UnrolledLinkedList {
+    static_assert(CHUNK_CAPACITY >= 2, "Chunk must hold at least two elements");
+
+    struct Chunk;
+
+    // Ссылка на следующий блок; голова списка - ссылка без элементов
+    struct ChunkLink {
+        Chunk *next_chunk = nullptr;
+    };
+
+    struct Chunk : ChunkLink {
+        Type *Values() noexcept {
+            return std::launder(reinterpret_cast<Type *>(storage));
         }
 
-        int *deletion_counter_ptr = nullptr;
+        size_t count = 0;
+        alignas(Type) unsigned char storage[sizeof(Type) * CHUNK_CAPACITY];
     };
 
-    // Проверка PopFront
-    {
-        SingleLinkedList<int> numbers{3, 14, 15, 92, 6};
-        numbers.PopFront();
-        assert((numbers == SingleLinkedList<int>{14, 15, 92, 6}));
+    // Индекс итератора, стоящего перед первым элементом блоков после ссылки
+    static constexpr size_t BEFORE_FIRST = static_cast<size_t>(-1);
 
-        SingleLinkedList<DeletionSpy> list;
-        list.PushFront(DeletionSpy{});
-        int deletion_counter = 0;
-        list.begin()->deletion_counter_ptr = &deletion_counter;
-        assert(deletion_counter == 0);
-        list.PopFront();
-        assert(deletion_counter == 1);
-    }
+public:
 
-    // Доступ к позиции, предшествующей begin
-    {
-        SingleLinkedList<int> empty_list;
-        const auto &const_empty_list = empty_list;
-        assert(empty_list.before_begin() == empty_list.cbefore_begin());
-        assert(++empty_list.before_begin() == empty_list.begin());
-        assert(++empty_list.cbefore_begin() == const_empty_list.begin());
+    template<typename ValueType>
+    class BasicIterator {
 
-        SingleLinkedList<int> numbers{1, 2, 3, 4};
-        const auto &const_numbers = numbers;
-        assert(numbers.before_begin() == numbers.cbefore_begin());
-        assert(++numbers.before_begin() == numbers.begin());
-        assert(++numbers.cbefore_begin() == const_numbers.begin());
-    }
+        friend class UnrolledLinkedList;
+
+        template<typename> friend
+        class BasicIterator;
+
+        BasicIterator(ChunkLink *link, size_t index)
+                : link_(link), index_(index) {
 
-    // Вставка элемента после указанной позиции
-    {  // Вставка в пустой список
-        {
-            SingleLinkedList<int> lst;
-            const auto inserted_item_pos = lst.InsertAfter(lst.before_begin(), 123);
-            assert((lst == SingleLinkedList<int>{123}));
-            assert(inserted_item_pos == lst.begin());
-            assert(*inserted_item_pos == 123);
         }
 
-        // Вставка в непустой список
-        {
-            SingleLinkedList<int> lst{1, 2, 3};
-            auto inserted_item_pos = lst.InsertAfter(lst.before_begin(), 123);
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = ValueType *;
+        using reference = ValueType &;
 
-            assert(inserted_item_pos == lst.begin());
-            assert(inserted_item_pos != lst.end());
-            assert(*inserted_item_pos == 123);
-            assert((lst == SingleLinkedList<int>{123, 1, 2, 3}));
+        BasicIterator() = default;
 
-            inserted_item_pos = lst.InsertAfter(lst.begin(), 555);
-            assert(++SingleLinkedList<int>::Iterator(lst.begin()) == inserted_item_pos);
-            assert(*inserted_item_pos == 555);
-            assert((lst == SingleLinkedList<int>{123, 555, 1, 2, 3}));
-        };
-    }
+        BasicIterator(const BasicIterator<Type> &other) noexcept
+                : link_(other.link_), index_(other.index_) {
 
-    // Вспомогательный класс, бросающий исключение после создания N-копии
-    struct ThrowOnCopy {
-        ThrowOnCopy() = default;
+        }
 
-        explicit ThrowOnCopy(int &copy_counter) noexcept
-                : countdown_ptr(&copy_counter) {
+        BasicIterator &operator=(const BasicIterator &rhs) = default;
+
+        [[nodiscard]] bool operator==(const BasicIterator<const Type> &rhs) const noexcept {
+            return (link_ == rhs.link_ && index_ == rhs.index_);
         }
 
-        ThrowOnCopy(const ThrowOnCopy &other)
-                : countdown_ptr(other.countdown_ptr)  //
-        {
-            if (countdown_ptr) {
-                if (*countdown_ptr == 0) {
-                    throw std::bad_alloc();
-                } else {
-                    --(*countdown_ptr);
-                }
-            }
+        [[nodiscard]] bool operator!=(const BasicIterator<const Type> &rhs) const noexcept {
+            return (!(*this == rhs));
         }
 
-        // Присваивание элементов этого типа не требуется
-        ThrowOnCopy &operator=(const ThrowOnCopy &rhs) = delete;
+        [[nodiscard]] bool operator==(const BasicIterator<Type> &rhs) const noexcept {
+            return (link_ == rhs.link_ && index_ == rhs.index_);
+        }
 
-        // Адрес счётчика обратного отсчёта. Если не равен nullptr, то уменьшается при каждом копировании.
-        // Как только обнулится, конструктор копирования выбросит исключение
-        int *countdown_ptr = nullptr;
-    };
+        [[nodiscard]] bool operator!=(const BasicIterator<Type> &rhs) const noexcept {
+            return (!(*this == rhs));
+        }
 
-    // Проверка обеспечения строгой гарантии безопасности исключений
-    {
-        bool exception_was_thrown = false;
-        for (int max_copy_counter = 10; max_copy_counter >= 0; --max_copy_counter) {
-            SingleLinkedList<ThrowOnCopy> list{ThrowOnCopy{}, ThrowOnCopy{}, ThrowOnCopy{}};
-            try {
-                int copy_counter = max_copy_counter;
-                list.InsertAfter(list.cbegin(), ThrowOnCopy(copy_counter));
-                assert(list.GetSize() == 4u);
-            } catch (const std::bad_alloc &) {
-                exception_was_thrown = true;
-                assert(list.GetSize() == 3u);
-                break;
+        BasicIterator &operator++() noexcept {
+            assert(link_ != nullptr);
+            if (index_ == BEFORE_FIRST || index_ + 1 == GetChunk()->count) {
+                link_ = link_->next_chunk;
+                index_ = 0;
+            } else {
+                ++index_;
             }
+            return (*this);
         }
-        assert(exception_was_thrown);
-    }
 
-    // Удаление элементов после указанной позиции
-    {
-        {
-            SingleLinkedList<int> lst{1, 2, 3, 4};
-            const auto &const_lst = lst;
-            const auto item_after_erased = lst.EraseAfter(const_lst.cbefore_begin());
-            assert((lst == SingleLinkedList<int>{2, 3, 4}));
-            assert(item_after_erased == lst.begin());
+        BasicIterator operator++(int) noexcept {
+            auto old_value(*this);
+            ++(*this);
+            return old_value;
         }
-        {
-            SingleLinkedList<int> lst{1, 2, 3, 4};
-            const auto item_after_erased = lst.EraseAfter(lst.cbegin());
-            assert((lst == SingleLinkedList<int>{1, 3, 4}));
-            assert(item_after_erased == (++lst.begin()));
+
+        [[nodiscard]] reference operator*() const noexcept {
+            return GetChunk()->Values()[index_];
         }
-        {
-            SingleLinkedList<int> lst{1, 2, 3, 4};
-            const auto item_after_erased = lst.EraseAfter(++(++lst.cbegin()));
-            assert((lst == SingleLinkedList<int>{1, 2, 3}));
-            assert(item_after_erased == lst.end());
+
+        [[nodiscard]] pointer operator->() const noexcept {
+            return &**this;
         }
-        {
-            SingleLinkedList<DeletionSpy> list{DeletionSpy{}, DeletionSpy{}, DeletionSpy{}};
-            auto after_begin = ++list.begin();
-            int deletion_counter = 0;
-            after_begin->deletion_counter_ptr = &deletion_counter;
-            assert(deletion_counter == 0u);
-            list.EraseAfter(list.cbegin());
-            assert(deletion_counter == 1u);
+
+    private:
+        Chunk *GetChunk() const noexcept {
+            assert(link_ != nullptr && index_ != BEFORE_FIRST);
+            return static_cast<Chunk *>(link_);
+        }
+
+        ChunkLink *link_ = nullptr;
+        size_t index_ = 0;
+    };
+
+public:
+    using value_type = Type;
+    using reference = value_type &;
+    using const_reference = const value_type &;
+
+    using Iterator = BasicIterator<Type>;
+    using ConstIterator = BasicIterator<const Type>;
+
+    UnrolledLinkedList() = default;
+
+    UnrolledLinkedList(std::initializer_list<Type> values) {
+        UnrolledLinkedList tmp;
+        tmp.Append(values.begin(), values.end());
+        swap(tmp);
+    }
+
+    // Копия заполняется за один проход, блоки копии заполнены целиком
+    UnrolledLinkedList(const UnrolledLinkedList &other) {
+        UnrolledLinkedList tmp;
+        tmp.Append(other.begin(), other.end());
+        swap(tmp);
+    }
+
+    UnrolledLinkedList(UnrolledLinkedList &&other) noexcept {
+        swap(other);
+    }
+
+    UnrolledLinkedList &operator=(const UnrolledLinkedList &rhs) {
+        if (this != &rhs) {
+            UnrolledLinkedList tmp(rhs);
+            swap(tmp);
         }
+        return *this;
     }
+
+    UnrolledLinkedList &operator=(UnrolledLinkedList &&rhs) noexcept {
+        if (this != &rhs) {
+            Clear();
+            swap(rhs);
+        }
+        return *this;
+    }
+
+    ~UnrolledLinkedList() {
+        Clear();
+    }
+
+    [[nodiscard]] Iterator begin() noexcept {
+        return Iterator{head_.next_chunk, 0};
+    }
+
+    [[nodiscard]] Iterator end() noexcept {
+        return Iterator{nullptr, 0};
+    }
+
+    [[nodiscard]] ConstIterator begin() const noexcept {
+        return ConstIterator{head_.next_chunk, 0};
+    }
+
+    [[nodiscard]] ConstIterator end() const noexcept {
+        return ConstIterator{nullptr, 0};
+    }
+
+    [[nodiscard]] ConstIterator cbegin() const noexcept {
+        return begin();
+    }
+
+    [[nodiscard]] ConstIterator cend() const noexcept {
+        return end();
+    }
+
+    [[nodiscard]] Iterator before_begin() noexcept {
+        return Iterator{&head_, BEFORE_FIRST};
+    }
+
+    [[nodiscard]] ConstIterator cbefore_begin() const noexcept {
+        return ConstIterator{const_cast<ChunkLink *>(&head_), BEFORE_FIRST};
+    }
+
+    [[nodiscard]] ConstIterator before_begin() const noexcept {
+        return cbefore_begin();
+    }
+
+    [[nodiscard]] size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    [[nodiscard]] bool IsEmpty() const noexcept {
+        return (size_ == 0);
+    }
+
+    // Память под блоки в байтах
+    [[nodiscard]] size_t GetMemoryUsage() const noexcept {
+        return chunk_count_ * sizeof(Chunk);
+    }
+
+    void PushFront(const Type &value) {
+        InsertAfter(before_begin(), value);
+    }
+
+    void PopFront() noexcept {
+        EraseAfter(cbefore_begin());
+    }
+
+    // Очищает список за время O(N)
+    void Clear() noexcept {
+        while (head_.next_chunk != nullptr) {
+            Chunk *chunk = head_.next_chunk;
+            head_.next_chunk = chunk->next_chunk;
+            std::destroy_n(chunk->Values(), chunk->count);
+            delete chunk;
+        }
+        size_ = 0;
+        chunk_count_ = 0;
+    }
+
+    void swap(UnrolledLinkedList &other) noexcept {
+        std::swap(head_.next_chunk, other.head_.next_chunk);
+        std::swap(size_, other.size_);
+        std::swap(chunk_count_, other.chunk_count_);
+    }
+
+    Iterator InsertAfter(ConstIterator pos, const Type &value) {
+        return Insert(pos, value);
+    }
+
+    Iterator InsertAfter(ConstIterator pos, Type &&value) {
+        return Insert(pos, std::move(value));
+    }
+
+    /*
+     * Удаляет элемент, следующий за pos.
+     * Возвращает итератор на элемент, следующий за удалённым
+     */
+    Iterator EraseAfter(ConstIterator pos) noexcept {
+        ConstIterator target = std::next(pos);
+        Chunk *chunk = target.GetChunk();
+        const size_t index = target.index_;
+        Type *values = chunk->Values();
+        std::move(values + index + 1, values + chunk->count, values + index);
+        std::destroy_at(values + chunk->count - 1);
+        --chunk->count;
+        --size_;
+        if (chunk->count == 0) {
+            // в блоке был только удалённый элемент, значит pos стоит в предыдущем блоке или перед началом
+            pos.link_->next_chunk = chunk->next_chunk;
+            Chunk *next_chunk = chunk->next_chunk;
+            FreeChunk(chunk);
+            return Iterator{next_chunk, 0};
+        }
+        MergeWithNext(chunk);
+        if (index < chunk->count) {
+            return Iterator{chunk, index};
+        }
+        return Iterator{chunk->next_chunk, 0};
+    }
+
+private:
+    ChunkLink head_;
+    size_t size_ = 0;
+    size_t chunk_count_ = 0;
+
+    template<typename Value>
+    Iterator Insert(ConstIterator pos, Value &&value) {
+        assert(pos.link_ != nullptr);
+        if (pos.index_ == BEFORE_FIRST) {
+            if (head_.next_chunk == nullptr) {
+                return InsertIntoNewChunk(&head_, std::forward<Value>(value));
+            }
+            return InsertAt(head_.next_chunk, 0, std::forward<Value>(value));
+        }
+        return InsertAt(pos.GetChunk(), pos.index_ + 1, std::forward<Value>(value));
+    }
+
+    // Вставляет значение на место index блока chunk (index <= chunk->count)
+    template<typename Value>
+    Iterator InsertAt(Chunk *chunk, size_t index, Value &&value) {
+        if (chunk->count < CHUNK_CAPACITY) {
+            InsertIntoChunk(chunk, index, std::forward<Value>(value));
+            return Iterator{chunk, index};
+        }
+        if (index == CHUNK_CAPACITY) {
+            // после конца полного блока - в начало следующего, если в нём есть место, иначе в новый блок
+            Chunk *next_chunk = chunk->next_chunk;
+            if (next_chunk != nullptr && next_chunk->count < CHUNK_CAPACITY) {
+                InsertIntoChunk(next_chunk, 0, std::forward<Value>(value));
+                return Iterator{next_chunk, 0};
+            }
+            return InsertIntoNewChunk(chunk, std::forward<Value>(value));
+        }
+        // значение создаётся до деления, чтобы исключение при копировании не меняло список
+        Type new_value(std::forward<Value>(value));
+        Chunk *second_half = AllocateChunk(chunk);
+        constexpr size_t HALF = CHUNK_CAPACITY / 2;
+        Type *values = chunk->Values();
+        std::uninitialized_move(values + HALF, values + CHUNK_CAPACITY, second_half->Values());
+        std::destroy(values + HALF, values + CHUNK_CAPACITY);
+        second_half->count = CHUNK_CAPACITY - HALF;
+        chunk->count = HALF;
+        if (index <= HALF) {
+            InsertIntoChunk(chunk, index, std::move(new_value));
+            return Iterator{chunk, index};
+        }
+        InsertIntoChunk(second_half, index - HALF, std::move(new_value));
+        return Iterator{second_half, index - HALF};
+    }
+
+    // Создаёт блок с единственным значением после ссылки link
+    template<typename Value>
+    Iterator InsertIntoNewChunk(ChunkLink *link, Value &&value) {
+        std::unique_ptr<Chunk> chunk(new Chunk);
+        new(chunk->Values()) Type(std::forward<Value>(value));
+        chunk->count = 1;
+        chunk->next_chunk = link->next_chunk;
+        link->next_chunk = chunk.release();
+        ++chunk_count_;
+        ++size_;
+        return Iterator{link->next_chunk, 0};
+    }
+
+    // Вставка в неполный блок со сдвигом хвоста блока
+    template<typename Value>
+    void InsertIntoChunk(Chunk *chunk, size_t index, Value &&value) {
+        Type *values = chunk->Values();
+        if (index == chunk->count) {
+            new(values + index) Type(std::forward<Value>(value));
+        } else {
+            Type new_value(std::forward<Value>(value));
+            new(values + chunk->count) Type(std::move(values[chunk->count - 1]));
+            std::move_backward(values + index, values + chunk->count - 1, values + chunk->count);
+            values[index] = std::move(new_value);
+        }
+        ++chunk->count;
+        ++size_;
+    }
+
+    // Пустой блок после chunk
+    Chunk *AllocateChunk(Chunk *chunk) {
+        Chunk *new_chunk = new Chunk;
+        new_chunk->next_chunk = chunk->next_chunk;
+        chunk->next_chunk = new_chunk;
+        ++chunk_count_;
+        return new_chunk;
+    }
+
+    void FreeChunk(Chunk *chunk) noexcept {
+        delete chunk;
+        --chunk_count_;
+    }
+
+    void MergeWithNext(Chunk *chunk) noexcept {
+        Chunk *next_chunk = chunk->next_chunk;
+        if (next_chunk == nullptr || chunk->count + next_chunk->count > CHUNK_CAPACITY / 2) {
+            return;
+        }
+        std::uninitialized_move_n(next_chunk->Values(), next_chunk->count, chunk->Values() + chunk->count);
+        std::destroy_n(next_chunk->Values(), next_chunk->count);
+        chunk->count += next_chunk->count;
+        chunk->next_chunk = next_chunk->next_chunk;
+        FreeChunk(next_chunk);
+    }
+
+    // Дописывает элементы в конец, заполняя блоки целиком
+    template<typename InputIterator>
+    void Append(InputIterator first, InputIterator last) {
+        ChunkLink *tail = &head_;
+        while (tail->next_chunk != nullptr) {
+            tail = tail->next_chunk;
+        }
+        for (; first != last; ++first) {
+            Chunk *chunk = tail == &head_ ? nullptr : static_cast<Chunk *>(tail);
+            if (chunk != nullptr && chunk->count < CHUNK_CAPACITY) {
+                InsertIntoChunk(chunk, chunk->count, *first);
+            } else {
+                InsertIntoNewChunk(tail, *first);
+                tail = tail->next_chunk;
+            }
+        }
+    }
+};
+
+template<typename Type, size_t CHUNK_CAPACITY>
+void swap(UnrolledLinkedList<Type, CHUNK_CAPACITY> &lhs, UnrolledLinkedList<Type, CHUNK_CAPACITY> &rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+template<typename Type, size_t CHUNK_CAPACITY>
+bool operator==(const UnrolledLinkedList<Type, CHUNK_CAPACITY> &lhs, const UnrolledLinkedList<Type, CHUNK_CAPACITY> &rhs) {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template<typename Type, size_t CHUNK_CAPACITY>
+bool operator!=(const UnrolledLinkedList<Type, CHUNK_CAPACITY> &lhs, const UnrolledLinkedList<Type, CHUNK_CAPACITY> &rhs) {
+    return !(lhs == rhs);
+}
+
+template<typename Type, size_t CHUNK_CAPACITY>
+bool operator<(const UnrolledLinkedList<Type, CHUNK_CAPACITY> &lhs, const UnrolledLinkedList<Type, CHUNK_CAPACITY> &rhs) {
+    return std::lexicographical_compare(lhs.begin(), lhs.end(),
+                                        rhs.begin(), rhs.end());
+}
+
+template<typename Type, size_t CHUNK_CAPACITY>
+bool operator<=(const UnrolledLinkedList<Type, CHUNK_CAPACITY> &lhs, const UnrolledLinkedList<Type, CHUNK_CAPACITY> &rhs) {
+    return !(rhs < lhs);
+}
+
+template<typename Type, size_t CHUNK_CAPACITY>
+bool operator>(const UnrolledLinkedList<Type, CHUNK_CAPACITY> &lhs, const UnrolledLinkedList<Type, CHUNK_CAPACITY> &rhs) {
+    return rhs < lhs;
+}
+
+template<typename Type, size_t CHUNK_CAPACITY>
+bool operator>=(const UnrolledLinkedList<Type, CHUNK_CAPACITY> &lhs, const UnrolledLinkedList<Type, CHUNK_CAPACITY> &rhs) {
+    return !(lhs < rhs);
+}
+
+/*
+ * Hazard pointers для безопасного освобождения узлов lock-free структур.
+ * Поток, читающий узел общей структуры, объявляет его адрес в своей ячейке (Protect),
+ * снятые со структуры узлы копятся в списке потока (Retire) и освобождаются, когда
+ * набирается RECLAIM_THRESHOLD узлов и ни одна ячейка их не объявляет.
+ * У каждого потока одна ячейка, потоков одновременно - не больше MAX_THREADS
+ */
+class HazardPointers {
+public:
+    static constexpr size_t MAX_THREADS = 128;
+
+    // Объявляет узел, на который указывает source, и возвращает его.
+    // Адрес перечитывается, пока не совпадёт с объявленным: узел не мог быть освобождён до объявления
+    template<typename Node>
+    static Node *Protect(const std::atomic<Node *> &source) {
+        std::atomic<void *> &slot = GetRecord().pointer;
+        Node *node = source.load();
+        while (true) {
+            slot.store(node);
+            Node *current = source.load();
+            if (current == node) {
+                return node;
+            }
+            node = current;
+        }
+    }
+
+    static void Clear() noexcept {
+        GetRecord().pointer.store(nullptr, std::memory_order_release);
+    }
+
+    // Передаёт узел на освобождение; узел уже не должен быть доступен из структуры.
+    // Не бросает исключений, поэтому вызывается из деструкторов: если памяти под список
+    // снятых узлов не хватило, поток дожидается, пока узел никто не объявляет, и освобождает его сам
+    template<typename Node>
+    static void Retire(Node *node) noexcept {
+        const Retired retired_node{node, [](void *pointer) { delete static_cast<Node *>(pointer); }};
+        RetiredList &retired = GetRetiredOwner().list;
+        try {
+            retired.push_back(retired_node);
+        } catch (...) {
+            DeleteWhenUnprotected(retired_node);
+            return;
+        }
+        if (retired.size() >= RECLAIM_THRESHOLD) {
+            Reclaim(retired);
+        }
+    }
+
+private:
+    static constexpr size_t RECLAIM_THRESHOLD = 2 * MAX_THREADS;
+
+    struct Record {
+        std::atomic<bool> active{false};
+        std::atomic<void *> pointer{nullptr};
+    };
+
+    struct Retired {
+        void *pointer;
+        void (*deleter)(void *);
+    };
+
+    using RetiredList = std::vector<Retired>;
+
+    // Занимает свободную ячейку при первом обращении потока и освобождает при его завершении
+    struct RecordOwner {
+        RecordOwner() {
+            for (Record &record : GetRecords()) {
+                bool expected = false;
+                if (record.active.compare_exchange_strong(expected, true)) {
+                    this->record = &record;
+                    return;
+                }
+            }
+            throw std::runtime_error("Too many threads use hazard pointers");
+        }
+
+        ~RecordOwner() {
+            record->pointer.store(nullptr);
+            record->active.store(false);
+        }
+
+        Record *record = nullptr;
+    };
+
+    // Узлы, которые ещё объявлены другими потоками при завершении потока, переходят в orphans_
+    // и освобождаются при следующей чистке в любом потоке
+    struct RetiredOwner {
+        ~RetiredOwner() {
+            Reclaim(list);
+            if (list.empty()) {
+                return;
+            }
+            std::lock_guard guard(orphans_mutex_);
+            try {
+                orphans_.list.insert(orphans_.list.end(), list.begin(), list.end());
+            } catch (...) {
+                for (const Retired &node : list) {
+                    DeleteWhenUnprotected(node);
+                }
+            }
+        }
+
+        RetiredList list;
+    };
+
+    // Осиротевшие узлы, которые так и не освободила ни одна чистка, освобождаются при завершении программы:
+    // к этому времени потоки, работавшие со структурами, уже завершены и узлы никто не объявляет
+    struct OrphanList {
+        ~OrphanList() {
+            for (const Retired &node : list) {
+                node.deleter(node.pointer);
+            }
+        }
+
+        RetiredList list;
+    };
+
+    inline static std::mutex orphans_mutex_;
+    inline static OrphanList orphans_;
+
+    static std::array<Record, MAX_THREADS> &GetRecords() {
+        static std::array<Record, MAX_THREADS> records;
+        return records;
+    }
+
+    static Record &GetRecord() {
+        thread_local RecordOwner owner;
+        return *owner.record;
+    }
+
+    static RetiredOwner &GetRetiredOwner() {
+        thread_local RetiredOwner owner;
+        return owner;
+    }
+
+    // Освобождает необъявленные узлы списка потока и осиротевшие узлы; память не выделяет
+    static void Reclaim(RetiredList &retired) noexcept {
+        std::array<void *, MAX_THREADS> hazards{};
+        size_t hazard_count = 0;
+        for (const Record &record : GetRecords()) {
+            if (void *pointer = record.pointer.load(); pointer != nullptr) {
+                hazards[hazard_count++] = pointer;
+            }
+        }
+        const auto hazards_end = hazards.begin() + hazard_count;
+        std::sort(hazards.begin(), hazards_end);
+        const auto delete_unprotected = [&hazards, hazards_end](RetiredList &nodes) {
+            const auto still_hazardous = std::partition(nodes.begin(), nodes.end(), [&hazards, hazards_end](const Retired &node) {
+                return std::binary_search(hazards.begin(), hazards_end, node.pointer);
+            });
+            for (auto it = still_hazardous; it != nodes.end(); ++it) {
+                it->deleter(it->pointer);
+            }
+            nodes.erase(still_hazardous, nodes.end());
+        };
+        delete_unprotected(retired);
+        std::lock_guard guard(orphans_mutex_);
+        delete_unprotected(orphans_.list);
+    }
+
+    // Узел уже снят со структуры, поэтому новые объявления его не удержат: Protect перечитывает источник
+    static void DeleteWhenUnprotected(const Retired &node) noexcept {
+        const auto is_protected = [&node] {
+            const auto &records = GetRecords();
+            return std::any_of(records.begin(), records.end(), [&node](const Record &record) {
+                return record.pointer.load() == node.pointer;
+            });
+        };
+        while (is_protected()) {
+            std::this_thread::yield();
+        }
+        node.deleter(node.pointer);
+    }
+};
+
+/*
+ * Lock-free стек (Treiber) на односвязных узлах того же вида, что у SingleLinkedList.
+ * PushFront и PopFront безопасны из любого числа потоков; снятые узлы освобождаются через
+ * HazardPointers, поэтому поток, читающий вершину, не обратится к освобождённой памяти,
+ * а повторное использование адреса (ABA) невозможно, пока адрес объявлен.
+ * PopAll забирает все элементы разом в SingleLinkedList для обхода итераторами
+ */
+template<typename Type>
+class ConcurrentStack {
+    struct Node {
+        Type value;
+        Node *next_node = nullptr;
+    };
+
+public:
+    ConcurrentStack() = default;
+
+    ConcurrentStack(const ConcurrentStack &) = delete;
+
+    ConcurrentStack &operator=(const ConcurrentStack &) = delete;
+
+    // Вызывается, когда стеком уже никто не пользуется
+    ~ConcurrentStack() {
+        Node *node = head_.load();
+        while (node != nullptr) {
+            delete std::exchange(node, node->next_node);
+        }
+    }
+
+    void PushFront(Type value) {
+        Node *node = new Node{std::move(value), head_.load(std::memory_order_relaxed)};
+        while (!head_.compare_exchange_weak(node->next_node, node,
+                                            std::memory_order_release, std::memory_order_relaxed)) {
+        }
+    }
+
+    // Снимает вершину; nullopt, если стек пуст
+    std::optional<Type> PopFront() {
+        Node *node = nullptr;
+        while (true) {
+            node = HazardPointers::Protect(head_);
+            if (node == nullptr) {
+                HazardPointers::Clear();
+                return std::nullopt;
+            }
+            if (head_.compare_exchange_strong(node, node->next_node)) {
+                break;
+            }
+        }
+        HazardPointers::Clear();
+        // узел уже снят со стека и передаётся на освобождение, даже если перемещение значения выбросит исключение
+        struct RetireGuard {
+            ~RetireGuard() {
+                HazardPointers::Retire(node);
+            }
+
+            Node *node;
+        } retire_guard{node};
+        return std::optional<Type>(std::move(node->value));
+    }
+
+    // Забирает все элементы в порядке от вершины. Если перенос элемента в список выбросит исключение,
+    // ещё не перенесённые элементы уничтожаются вместе с узлами: вернуть узлы в стек нельзя,
+    // поток, объявивший бывшую вершину, мог прочитать её старую ссылку на следующий узел
+    SingleLinkedList<Type> PopAll() {
+        Node *node = head_.exchange(nullptr);
+        struct RetireRestGuard {
+            ~RetireRestGuard() {
+                while (node != nullptr) {
+                    HazardPointers::Retire(std::exchange(node, node->next_node));
+                }
+            }
+
+            Node *&node;
+        } retire_rest_guard{node};
+        SingleLinkedList<Type> values;
+        auto last = values.before_begin();
+        while (node != nullptr) {
+            last = values.InsertAfter(last, std::move(node->value));
+            HazardPointers::Retire(std::exchange(node, node->next_node));
+        }
+        return values;
+    }
+
+    // Результат может устареть сразу после вызова
+    [[nodiscard]] bool IsEmpty() const noexcept {
+        return head_.load() == nullptr;
+    }
+
+private:
+    std::atomic<Node *> head_{nullptr};
+};
+
+void Test4() {
+    struct DeletionSpy {
+        ~DeletionSpy() {
+            if (deletion_counter_ptr) {
+                ++(*deletion_counter_ptr);
+            }
+        }
+
+        int *deletion_counter_ptr = nullptr;
+    };
+
+    // Проверка PopFront
+    {
+        SingleLinkedList<int> numbers{3, 14, 15, 92, 6};
+        numbers.PopFront();
+        assert((numbers == SingleLinkedList<int>{14, 15, 92, 6}));
+
+        SingleLinkedList<DeletionSpy> list;
+        list.PushFront(DeletionSpy{});
+        int deletion_counter = 0;
+        list.begin()->deletion_counter_ptr = &deletion_counter;
+        assert(deletion_counter == 0);
+        list.PopFront();
+        assert(deletion_counter == 1);
+    }
+
+    // Доступ к позиции, предшествующей begin
+    {
+        SingleLinkedList<int> empty_list;
+        const auto &const_empty_list = empty_list;
+        assert(empty_list.before_begin() == empty_list.cbefore_begin());
+        assert(++empty_list.before_begin() == empty_list.begin());
+        assert(++empty_list.cbefore_begin() == const_empty_list.begin());
+
+        SingleLinkedList<int> numbers{1, 2, 3, 4};
+        const auto &const_numbers = numbers;
+        assert(numbers.before_begin() == numbers.cbefore_begin());
+        assert(++numbers.before_begin() == numbers.begin());
+        assert(++numbers.cbefore_begin() == const_numbers.begin());
+    }
+
+    // Вставка элемента после указанной позиции
+    {  // Вставка в пустой список
+        {
+            SingleLinkedList<int> lst;
+            const auto inserted_item_pos = lst.InsertAfter(lst.before_begin(), 123);
+            assert((lst == SingleLinkedList<int>{123}));
+            assert(inserted_item_pos == lst.begin());
+            assert(*inserted_item_pos == 123);
+        }
+
+        // Вставка в непустой список
+        {
+            SingleLinkedList<int> lst{1, 2, 3};
+            auto inserted_item_pos = lst.InsertAfter(lst.before_begin(), 123);
+
+            assert(inserted_item_pos == lst.begin());
+            assert(inserted_item_pos != lst.end());
+            assert(*inserted_item_pos == 123);
+            assert((lst == SingleLinkedList<int>{123, 1, 2, 3}));
+
+            inserted_item_pos = lst.InsertAfter(lst.begin(), 555);
+            assert(++SingleLinkedList<int>::Iterator(lst.begin()) == inserted_item_pos);
+            assert(*inserted_item_pos == 555);
+            assert((lst == SingleLinkedList<int>{123, 555, 1, 2, 3}));
+        };
+    }
+
+    // Вспомогательный класс, бросающий исключение после создания N-копии
+    struct ThrowOnCopy {
+        ThrowOnCopy() = default;
+
+        explicit ThrowOnCopy(int &copy_counter) noexcept
+                : countdown_ptr(&copy_counter) {
+        }
+
+        ThrowOnCopy(const ThrowOnCopy &other)
+                : countdown_ptr(other.countdown_ptr)  //
+        {
+            if (countdown_ptr) {
+                if (*countdown_ptr == 0) {
+                    throw std::bad_alloc();
+                } else {
+                    --(*countdown_ptr);
+                }
+            }
+        }
+
+        // Присваивание элементов этого типа не требуется
+        ThrowOnCopy &operator=(const ThrowOnCopy &rhs) = delete;
+
+        // Адрес счётчика обратного отсчёта. Если не равен nullptr, то уменьшается при каждом копировании.
+        // Как только обнулится, конструктор копирования выбросит исключение
+        int *countdown_ptr = nullptr;
+    };
+
+    // Проверка обеспечения строгой гарантии безопасности исключений
+    {
+        bool exception_was_thrown = false;
+        for (int max_copy_counter = 10; max_copy_counter >= 0; --max_copy_counter) {
+            SingleLinkedList<ThrowOnCopy> list{ThrowOnCopy{}, ThrowOnCopy{}, ThrowOnCopy{}};
+            try {
+                int copy_counter = max_copy_counter;
+                list.InsertAfter(list.cbegin(), ThrowOnCopy(copy_counter));
+                assert(list.GetSize() == 4u);
+            } catch (const std::bad_alloc &) {
+                exception_was_thrown = true;
+                assert(list.GetSize() == 3u);
+                break;
+            }
+        }
+        assert(exception_was_thrown);
+    }
+
+    // Удаление элементов после указанной позиции
+    {
+        {
+            SingleLinkedList<int> lst{1, 2, 3, 4};
+            const auto &const_lst = lst;
+            const auto item_after_erased = lst.EraseAfter(const_lst.cbefore_begin());
+            assert((lst == SingleLinkedList<int>{2, 3, 4}));
+            assert(item_after_erased == lst.begin());
+        }
+        {
+            SingleLinkedList<int> lst{1, 2, 3, 4};
+            const auto item_after_erased = lst.EraseAfter(lst.cbegin());
+            assert((lst == SingleLinkedList<int>{1, 3, 4}));
+            assert(item_after_erased == (++lst.begin()));
+        }
+        {
+            SingleLinkedList<int> lst{1, 2, 3, 4};
+            const auto item_after_erased = lst.EraseAfter(++(++lst.cbegin()));
+            assert((lst == SingleLinkedList<int>{1, 2, 3}));
+            assert(item_after_erased == lst.end());
+        }
+        {
+            SingleLinkedList<DeletionSpy> list{DeletionSpy{}, DeletionSpy{}, DeletionSpy{}};
+            auto after_begin = ++list.begin();
+            int deletion_counter = 0;
+            after_begin->deletion_counter_ptr = &deletion_counter;
+            assert(deletion_counter == 0u);
+            list.EraseAfter(list.cbegin());
+            assert(deletion_counter == 1u);
+        }
+    }
+}
+
+void Test5() {
+    using IntList = SingleLinkedList<int>;
+
+    // Освобождённые узлы переиспользуются
+    {
+        IntList list{1, 2, 3};
+        const int *first_node_value = &*list.begin();
+        list.PopFront();
+        list.PushFront(10);
+        assert(&*list.begin() == first_node_value);
+        assert((list == IntList{10, 2, 3}));
+    }
+
+    // Вставка диапазона после позиции
+    {
+        IntList list{1, 5};
+        const std::vector<int> values{2, 3, 4};
+        auto last_inserted = list.InsertAfter(list.cbegin(), values.begin(), values.end());
+        assert(*last_inserted == 4);
+        assert((list == IntList{1, 2, 3, 4, 5}));
+        assert(list.GetSize() == 5u);
+
+        last_inserted = list.InsertAfter(list.cbefore_begin(), values.begin(), values.begin());
+        assert(last_inserted == list.before_begin());
+        assert(list.GetSize() == 5u);
+
+        list.InsertAfter(list.cbefore_begin(), {-1, 0});
+        assert((list == IntList{-1, 0, 1, 2, 3, 4, 5}));
+    }
+
+    // Удаление диапазона
+    {
+        IntList list{1, 2, 3, 4, 5};
+        auto after_erased = list.EraseAfter(list.cbegin(), ++(++(++(++list.cbegin()))));
+        assert(*after_erased == 5);
+        assert((list == IntList{1, 5}));
+        assert(list.GetSize() == 2u);
+    }
+
+    // Копирование сохраняет порядок, перемещение забирает узлы без копирования
+    {
+        IntList source{1, 2, 3};
+        IntList copy(source);
+        assert(copy == source);
+        assert(copy.GetPool() != source.GetPool());
+
+        const int *first_node_value = &*source.begin();
+        IntList moved(std::move(source));
+        assert(source.IsEmpty() && source.begin() == source.end());
+        assert(&*moved.begin() == first_node_value);
+        assert((moved == IntList{1, 2, 3}));
+
+        copy = std::move(moved);
+        assert(moved.IsEmpty());
+        assert(&*copy.begin() == first_node_value);
+
+        moved.PushFront(7);
+        assert((moved == IntList{7}));
+    }
+
+    // Перенос узлов между списками с общим пулом
+    {
+        auto pool = std::make_shared<IntList::NodePool>();
+        IntList lhs(pool);
+        IntList rhs(pool);
+        lhs.InsertAfter(lhs.cbefore_begin(), {1, 5});
+        rhs.InsertAfter(rhs.cbefore_begin(), {0, 2, 3, 4, 6});
+        const int *moved_value = &*(++rhs.begin());
+
+        lhs.SpliceAfter(lhs.cbegin(), rhs, rhs.cbegin(), ++(++(++(++rhs.cbegin()))));
+        assert((lhs == IntList{1, 2, 3, 4, 5}));
+        assert((rhs == IntList{0, 6}));
+        assert(lhs.GetSize() == 5u && rhs.GetSize() == 2u);
+        assert(&*(++lhs.begin()) == moved_value);
+
+        lhs.SpliceAfter(lhs.cbefore_begin(), rhs);
+        assert((lhs == IntList{0, 6, 1, 2, 3, 4, 5}));
+        assert(rhs.IsEmpty());
+    }
+
+    // Пустой список принимает узлы вместе с пулом, списки с разными пулами перемещают элементы
+    {
+        IntList source{1, 2};
+        const int *first_node_value = &*source.begin();
+        IntList empty;
+        empty.SpliceAfter(empty.cbefore_begin(), source);
+        assert(&*empty.begin() == first_node_value);
+        assert(empty.GetPool() == source.GetPool());
+
+        IntList other{3, 4};
+        empty.SpliceAfter(empty.cbegin(), other);
+        assert((empty == IntList{1, 3, 4, 2}));
+        assert(other.IsEmpty() && other.begin() == other.end());
+
+        auto pool = std::make_shared<IntList::NodePool>();
+        IntList with_pool(pool);
+        IntList values{5, 6};
+        with_pool.SpliceAfter(with_pool.cbefore_begin(), values);
+        assert(with_pool.GetPool() == pool);
+        assert((with_pool == IntList{5, 6}) && values.IsEmpty());
+
+        // Копирующее присваивание заполняет список узлами его пула, а не нового
+        const IntList source_values{7, 8, 9};
+        IntList copied(pool);
+        copied = source_values;
+        assert(copied.GetPool() == pool && (copied == IntList{7, 8, 9}));
+        copied.SpliceAfter(copied.cbefore_begin(), with_pool);
+        assert((copied == IntList{5, 6, 7, 8, 9}) && with_pool.IsEmpty());
+        copied = copied;
+        assert(copied.GetSize() == 5u && copied.GetPool() == pool);
+    }
+
+    // При исключении во время вставки диапазона список не меняется
+    {
+        struct ThrowOnCopy {
+            ThrowOnCopy() = default;
+
+            explicit ThrowOnCopy(int value) noexcept
+                    : value(value) {
+            }
+
+            ThrowOnCopy(const ThrowOnCopy &other)
+                    : value(other.value) {
+                if (value < 0) {
+                    throw std::bad_alloc();
+                }
+            }
+
+            int value = 0;
+        };
+
+        SingleLinkedList<ThrowOnCopy> list;
+        list.PushFront(ThrowOnCopy(1));
+        std::vector<ThrowOnCopy> values;
+        for (int value : {2, 3, -1}) {
+            values.emplace_back(value);
+        }
+        try {
+            list.InsertAfter(list.cbegin(), values.begin(), values.end());
+            assert(false);
+        } catch (const std::bad_alloc &) {
+        }
+        assert(list.GetSize() == 1u);
+        assert(list.begin()->value == 1 && ++list.begin() == list.end());
+    }
+}
+
+void Test6() {
+    // Однопоточная работа
+    {
+        ConcurrentStack<int> stack;
+        assert(stack.IsEmpty());
+        assert(!stack.PopFront().has_value());
+        stack.PushFront(1);
+        stack.PushFront(2);
+        assert(stack.PopFront() == 2);
+        stack.PushFront(3);
+        assert((stack.PopAll() == SingleLinkedList<int>{3, 1}));
+        assert(stack.IsEmpty());
+    }
+
+    // Производители и потребители: каждый элемент снимается ровно один раз
+    {
+        constexpr int PRODUCER_COUNT = 4;
+        constexpr int CONSUMER_COUNT = 4;
+        constexpr int VALUES_PER_PRODUCER = 20'000;
+        constexpr int VALUE_COUNT = PRODUCER_COUNT * VALUES_PER_PRODUCER;
+
+        ConcurrentStack<int> stack;
+        std::vector<std::atomic<int>> pop_counts(VALUE_COUNT);
+        std::atomic<int> popped{0};
+        std::vector<std::thread> threads;
+        for (int producer = 0; producer < PRODUCER_COUNT; ++producer) {
+            threads.emplace_back([&stack, producer] {
+                for (int i = 0; i < VALUES_PER_PRODUCER; ++i) {
+                    stack.PushFront(producer * VALUES_PER_PRODUCER + i);
+                }
+            });
+        }
+        for (int consumer = 0; consumer < CONSUMER_COUNT; ++consumer) {
+            threads.emplace_back([&] {
+                while (popped.load() < VALUE_COUNT) {
+                    if (const auto value = stack.PopFront()) {
+                        ++pop_counts[*value];
+                        ++popped;
+                    } else {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+        assert(stack.IsEmpty());
+        assert(std::all_of(pop_counts.begin(), pop_counts.end(), [](const std::atomic<int> &count) {
+            return count.load() == 1;
+        }));
+    }
+
+    // Потоки одновременно кладут и снимают строки: освобождённые узлы не читаются (проверяется под ASan)
+    {
+        constexpr int THREAD_COUNT = 8;
+        constexpr int ITERATION_COUNT = 10'000;
+
+        ConcurrentStack<std::string> stack;
+        std::atomic<size_t> total_length{0};
+        std::vector<std::thread> threads;
+        for (int thread = 0; thread < THREAD_COUNT; ++thread) {
+            threads.emplace_back([&stack, &total_length] {
+                for (int i = 0; i < ITERATION_COUNT; ++i) {
+                    stack.PushFront(std::string(32, 'x'));
+                    if (const auto value = stack.PopFront()) {
+                        total_length += value->size();
+                    }
+                }
+            });
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+        size_t rest_length = 0;
+        for (const std::string &value : stack.PopAll()) {
+            rest_length += value.size();
+        }
+        assert(total_length + rest_length == size_t{THREAD_COUNT} * ITERATION_COUNT * 32);
+    }
+
+    // Исключение при переносе элемента в PopAll: оставшиеся узлы освобождаются, а не теряются
+    {
+        // значение в фиктивном узле списка создаётся конструктором по умолчанию и не считается
+        struct ThrowOnMove {
+            ThrowOnMove() = default;
+
+            explicit ThrowOnMove(int *live_count, int *moves_before_throw)
+                    : live_count(live_count), moves_before_throw(moves_before_throw) {
+                ++*live_count;
+            }
+
+            ThrowOnMove(ThrowOnMove &&other)
+                    : live_count(other.live_count), moves_before_throw(other.moves_before_throw) {
+                if (live_count == nullptr) {
+                    return;
+                }
+                if (*moves_before_throw == 0) {
+                    throw std::runtime_error("move failed");
+                }
+                --*moves_before_throw;
+                ++*live_count;
+            }
+
+            ~ThrowOnMove() {
+                if (live_count != nullptr) {
+                    --*live_count;
+                }
+            }
+
+            int *live_count = nullptr;
+            int *moves_before_throw = nullptr;
+        };
+
+        int live_count = 0;
+        int moves_before_throw = 5;
+        {
+            ConcurrentStack<ThrowOnMove> stack;
+            for (int i = 0; i < 5; ++i) {
+                stack.PushFront(ThrowOnMove(&live_count, &moves_before_throw));
+            }
+            assert(live_count == 5);
+            moves_before_throw = 2;
+            bool thrown = false;
+            // узлы снимаются в отдельном потоке: при его завершении снятые узлы гарантированно освобождаются
+            std::thread([&stack, &thrown] {
+                try {
+                    stack.PopAll();
+                } catch (const std::runtime_error &) {
+                    thrown = true;
+                }
+            }).join();
+            assert(thrown);
+            assert(stack.IsEmpty());
+        }
+        assert(live_count == 0);
+    }
+}
+
+// Пропускная способность: каждый из thread_count потоков operation_count раз кладёт и снимает элемент.
+// Возвращает пар операций в секунду
+template<typename Push, typename Pop>
+double MeasureStackThroughput(size_t thread_count, size_t operation_count, Push push, Pop pop) {
+    std::vector<std::thread> threads;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t thread = 0; thread < thread_count; ++thread) {
+        threads.emplace_back([&push, &pop, operation_count] {
+            for (size_t i = 0; i < operation_count; ++i) {
+                push(static_cast<int>(i));
+                pop();
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return static_cast<double>(thread_count * operation_count) / elapsed.count();
+}
+
+// Сравнение ConcurrentStack со SingleLinkedList под мьютексом (CSV: структура,потоков,пар операций в секунду)
+void BenchmarkConcurrentStack() {
+    constexpr size_t OPERATION_COUNT = 100'000;
+    for (const size_t thread_count : {1, 2, 4, 8}) {
+        ConcurrentStack<int> stack;
+        const double lock_free = MeasureStackThroughput(
+                thread_count, OPERATION_COUNT,
+                [&stack](int value) { stack.PushFront(value); },
+                [&stack] { return stack.PopFront(); });
+        std::cout << "ConcurrentStack," << thread_count << ',' << lock_free << std::endl;
+
+        SingleLinkedList<int> list;
+        std::mutex list_mutex;
+        const double locked = MeasureStackThroughput(
+                thread_count, OPERATION_COUNT,
+                [&](int value) {
+                    std::lock_guard guard(list_mutex);
+                    list.PushFront(value);
+                },
+                [&] {
+                    std::lock_guard guard(list_mutex);
+                    if (!list.IsEmpty()) {
+                        list.PopFront();
+                    }
+                });
+        std::cout << "SingleLinkedList+mutex," << thread_count << ',' << locked << std::endl;
+    }
+}
+
+void Test7() {
+    using SmallChunkList = UnrolledLinkedList<int, 4>;
+
+    // Операции повторяют SingleLinkedList
+    {
+        SmallChunkList list;
+        assert(list.IsEmpty() && list.begin() == list.end());
+        assert(++list.before_begin() == list.end());
+
+        auto inserted = list.InsertAfter(list.cbefore_begin(), 2);
+        assert(inserted == list.begin() && *inserted == 2);
+        list.PushFront(1);
+        inserted = list.InsertAfter(++list.cbegin(), 3);
+        assert(*inserted == 3);
+        assert((list == SmallChunkList{1, 2, 3}));
+        assert(list.GetSize() == 3u);
+
+        const auto after_erased = list.EraseAfter(list.cbegin());
+        assert(*after_erased == 3);
+        assert((list == SmallChunkList{1, 3}));
+        list.PopFront();
+        list.PopFront();
+        assert(list.IsEmpty() && list.GetMemoryUsage() == 0u);
+    }
+
+    // Вставки в середину с делением полных блоков и удаления со слиянием против SingleLinkedList
+    {
+        SmallChunkList list;
+        SingleLinkedList<int> expected;
+        for (int value = 0; value < 200; ++value) {
+            const int steps = (value * 7) % (static_cast<int>(list.GetSize()) + 1);
+            auto pos = list.cbefore_begin();
+            auto expected_pos = expected.cbefore_begin();
+            for (int step = 0; step < steps; ++step) {
+                ++pos;
+                ++expected_pos;
+            }
+            assert(*list.InsertAfter(pos, value) == value);
+            expected.InsertAfter(expected_pos, value);
+        }
+        assert(std::equal(list.begin(), list.end(), expected.begin(), expected.end()));
+        assert(list.GetSize() == expected.GetSize());
+
+        while (!list.IsEmpty()) {
+            const int steps = static_cast<int>(list.GetSize() * 5 / 11);
+            auto pos = list.cbefore_begin();
+            auto expected_pos = expected.cbefore_begin();
+            for (int step = 0; step < steps; ++step) {
+                ++pos;
+                ++expected_pos;
+            }
+            const auto after_erased = list.EraseAfter(pos);
+            const auto expected_after_erased = expected.EraseAfter(expected_pos);
+            assert((after_erased == list.end()) == (expected_after_erased == expected.end()));
+            assert(after_erased == list.end() || *after_erased == *expected_after_erased);
+            assert(std::equal(list.begin(), list.end(), expected.begin(), expected.end()));
+        }
+        assert(list.GetMemoryUsage() == 0u);
+    }
+
+    // Итераторы на элементы других блоков переживают вставку и удаление
+    {
+        SmallChunkList list{1, 2, 3, 4, 5, 6, 7, 8};
+        auto second_chunk = list.cbegin();
+        std::advance(second_chunk, 4);
+        const int *second_chunk_value = &*second_chunk;
+        list.InsertAfter(list.cbegin(), 10);
+        list.EraseAfter(list.cbefore_begin());
+        assert(*second_chunk == 5 && &*second_chunk == second_chunk_value);
+        assert((list == SmallChunkList{10, 2, 3, 4, 5, 6, 7, 8}));
+    }
+
+    // Копирование плотно заполняет блоки, перемещение забирает их
+    {
+        SmallChunkList source;
+        auto last = source.cbefore_begin();
+        for (int value = 0; value < 8; ++value) {
+            last = source.InsertAfter(last, value);
+        }
+        // последовательная вставка заполняет блоки целиком: 8 элементов в двух блоках
+        const SmallChunkList one_chunk{0, 1, 2, 3};
+        assert(source.GetMemoryUsage() == 2 * one_chunk.GetMemoryUsage());
+
+        SmallChunkList copy(source);
+        assert(copy == source);
+        const int *first_value = &*source.begin();
+        SmallChunkList moved(std::move(source));
+        assert(source.IsEmpty() && &*moved.begin() == first_value);
+        copy = std::move(moved);
+        assert(moved.IsEmpty() && &*copy.begin() == first_value);
+    }
+
+    // Элементы разрушаются при удалении и очистке
+    {
+        struct DeletionSpy {
+            ~DeletionSpy() {
+                if (deletion_counter_ptr) {
+                    ++(*deletion_counter_ptr);
+                }
+            }
+
+            int *deletion_counter_ptr = nullptr;
+        };
+
+        int deletion_counter = 0;
+        {
+            UnrolledLinkedList<DeletionSpy, 4> list;
+            for (int i = 0; i < 6; ++i) {
+                list.PushFront(DeletionSpy{});
+                list.begin()->deletion_counter_ptr = &deletion_counter;
+            }
+            deletion_counter = 0;
+            list.EraseAfter(list.cbegin());
+            assert(deletion_counter == 1);
+        }
+        assert(deletion_counter == 6);
+    }
+}
+
+size_t GetMemoryUsage(const SingleLinkedList<int> &list) {
+    return list.GetSize() * SingleLinkedList<int>::NODE_SIZE;
+}
+
+template<size_t CHUNK_CAPACITY>
+size_t GetMemoryUsage(const UnrolledLinkedList<int, CHUNK_CAPACITY> &list) {
+    return list.GetMemoryUsage();
+}
+
+// Обход и вставка в середину для SingleLinkedList и UnrolledLinkedList из ELEMENT_COUNT чисел
+// (CSV: список,операция,нс на элемент); память - байт на элемент после заполнения и после вставок
+template<typename List>
+void MeasureListOperations(const std::string &name) {
+    constexpr int ELEMENT_COUNT = 1'000'000;
+    constexpr int SCAN_COUNT = 10;
+    constexpr int INSERT_STEP = 16;
+
+    List list;
+    auto last = list.cbefore_begin();
+    for (int value = 0; value < ELEMENT_COUNT; ++value) {
+        last = list.InsertAfter(last, value);
+    }
+
+    std::cout << name << ",bytes_per_element," << double(GetMemoryUsage(list)) / list.GetSize() << std::endl;
+
+    auto start = std::chrono::steady_clock::now();
+    long long sum = 0;
+    for (int scan = 0; scan < SCAN_COUNT; ++scan) {
+        for (const int value : list) {
+            sum += value;
+        }
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << name << ",scan," << elapsed.count() / (double{SCAN_COUNT} * ELEMENT_COUNT) << std::endl;
+
+    // после каждого INSERT_STEP-го элемента вставляется новый
+    start = std::chrono::steady_clock::now();
+    int position = 0;
+    for (auto it = list.cbegin(); it != list.cend(); ++it) {
+        if (++position % INSERT_STEP == 0) {
+            it = list.InsertAfter(it, 0);
+        }
+    }
+    elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << name << ",insert_every_" << INSERT_STEP << ',' << elapsed.count() / ELEMENT_COUNT << std::endl;
+    std::cout << name << ",bytes_per_element_after_insert,"
+              << double(GetMemoryUsage(list)) / list.GetSize() << std::endl;
+    if (sum == 1) {
+        std::cerr << sum;
+    }
+}
+
+void BenchmarkUnrolledList() {
+    MeasureListOperations<SingleLinkedList<int>>("SingleLinkedList");
+    MeasureListOperations<UnrolledLinkedList<int, 16>>("UnrolledLinkedList<16>");
+    MeasureListOperations<UnrolledLinkedList<int, 64>>("UnrolledLinkedList<64>");
 }
 
 unsigned n = 0;
@@ -458,6 +1885,11 @@ struct Z {
 
 int main() {
     Test4();
+    Test5();
+    Test6();
+    BenchmarkConcurrentStack();
+    Test7();
+    BenchmarkUnrolledList();
     SingleLinkedList<int> t1 = {1, 2, 3, 4, 5};
     SingleLinkedList<int> t2 = t1;
     SingleLinkedList<int> l = {1, 2, 3}, l2 = l;
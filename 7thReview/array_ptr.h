@@ -1,36 +1,81 @@
+#pragma once
+
 #include <cassert>
 #include <cstdlib>
 #include <algorithm>
+#include <memory>
+#include <type_traits>
+#include <utility>
 
-template <typename Type>
+//Владеющий указатель на массив из size созданных элементов.
+//Память выделяется распределителем Allocator, элементы создаются и разрушаются через std::allocator_traits
+template <typename Type, typename Allocator = std::allocator<Type>>
 class ArrayPtr {
+    using AllocTraits = std::allocator_traits<Allocator>;
+
 public:
+    static_assert(std::is_same_v<typename AllocTraits::pointer, Type*>, "ArrayPtr supports only allocators with raw pointers");
+
     ArrayPtr() = default;
 
-    explicit ArrayPtr(size_t size) {
+    explicit ArrayPtr(size_t size, const Allocator& allocator = Allocator())
+            : allocator_(allocator) {
         if (size == 0) {
-            raw_ptr_ = nullptr;
-        } else {
-            raw_ptr_ = new Type[size];
+            return;
+        }
+        Type* raw_ptr = AllocTraits::allocate(allocator_, size);
+        size_t constructed = 0;
+        try {
+            for (; constructed < size; ++constructed) {
+                AllocTraits::construct(allocator_, raw_ptr + constructed);
+            }
+        } catch (...) {
+            Destroy(raw_ptr, constructed);
+            AllocTraits::deallocate(allocator_, raw_ptr, size);
+            throw;
         }
+        raw_ptr_ = raw_ptr;
+        size_ = size;
     }
 
-    explicit ArrayPtr(Type* raw_ptr) noexcept {
-        raw_ptr_ = raw_ptr;
+    //принимает во владение массив из size элементов, созданных распределителем, равным allocator
+    ArrayPtr(Type* raw_ptr, size_t size, const Allocator& allocator = Allocator()) noexcept
+            : allocator_(allocator), raw_ptr_(raw_ptr), size_(raw_ptr != nullptr ? size : 0) {
     }
 
     ArrayPtr(const ArrayPtr&) = delete;
 
+    ArrayPtr(ArrayPtr&& other) noexcept
+            : allocator_(std::move(other.allocator_))
+            , raw_ptr_(std::exchange(other.raw_ptr_, nullptr))
+            , size_(std::exchange(other.size_, 0)) {
+    }
+
     ~ArrayPtr() {
-        delete[] raw_ptr_;
+        Free();
     }
 
     ArrayPtr& operator=(const ArrayPtr&) = delete;
 
+    //без propagate_on_container_move_assignment распределители должны быть равны
+    ArrayPtr& operator=(ArrayPtr&& rhs) noexcept {
+        if (this != &rhs) {
+            Free();
+            if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+                allocator_ = std::move(rhs.allocator_);
+            } else {
+                assert(allocator_ == rhs.allocator_);
+            }
+            raw_ptr_ = std::exchange(rhs.raw_ptr_, nullptr);
+            size_ = std::exchange(rhs.size_, 0);
+        }
+        return *this;
+    }
+
+    //отказывается от владения; освобождать массив (GetSize() элементов) должен вызывающий через GetAllocator()
     [[nodiscard]] Type* Release() noexcept {
-        Type* temp = raw_ptr_;
-        raw_ptr_ = nullptr;
-        return temp;
+        size_ = 0;
+        return std::exchange(raw_ptr_, nullptr);
     }
 
     Type& operator[](int index) noexcept {
@@ -49,10 +94,41 @@ public:
         return raw_ptr_;
     }
 
+    size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    Allocator GetAllocator() const {
+        return allocator_;
+    }
+
+    //распределители обмениваются только при propagate_on_container_swap, иначе должны быть равны
     void swap(ArrayPtr& other) noexcept {
+        if constexpr (AllocTraits::propagate_on_container_swap::value) {
+            using std::swap;
+            swap(allocator_, other.allocator_);
+        } else {
+            assert(allocator_ == other.allocator_);
+        }
         std::swap(raw_ptr_, other.raw_ptr_);
+        std::swap(size_, other.size_);
     }
 
 private:
+    Allocator allocator_;
     Type* raw_ptr_ = nullptr;
+    size_t size_ = 0;
+
+    void Destroy(Type* raw_ptr, size_t count) noexcept {
+        for (size_t i = 0; i < count; ++i) {
+            AllocTraits::destroy(allocator_, raw_ptr + i);
+        }
+    }
+
+    void Free() noexcept {
+        if (raw_ptr_ != nullptr) {
+            Destroy(raw_ptr_, size_);
+            AllocTraits::deallocate(allocator_, raw_ptr_, size_);
+        }
+    }
 };
\ No newline at end of file
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+//Сравнение непрерывных массивов для операторов сравнения векторов.
+//Для скалярных типов без «лишних» битов (целые, указатели) равенство - memcmp.
+//Порядок memcmp совпадает с operator< только для беззнаковых байтов, остальные арифметические
+//типы ищут первое различие блоками: внутри блока нет досрочного выхода, и сравнения идут векторно
+//(целые - автовекторизацией, float и double - SSE2).
+//Числа с плавающей точкой сравниваются своими операторами: memcmp считал бы NaN равным себе,
+//а +0 и -0 - разными
+
+//элементов в блоке, который проверяется целиком
+inline constexpr size_t COMPARE_BLOCK_SIZE = 32;
+
+//равенство объектов типа совпадает с равенством их байтов
+template <typename Type>
+inline constexpr bool IS_BITWISE_COMPARABLE = std::is_scalar_v<Type> && std::has_unique_object_representations_v<Type>;
+
+//лексикографический порядок совпадает с порядком memcmp
+template <typename Type>
+inline constexpr bool IS_BYTEWISE_ORDERED = std::is_same_v<Type, unsigned char> || std::is_same_v<Type, std::byte>
+                                            || std::is_same_v<Type, bool> || (std::is_same_v<Type, char> && !std::is_signed_v<char>);
+
+//сравнения элементов не выбрасывают исключений
+template <typename Type>
+inline constexpr bool IS_NOTHROW_EQUALITY_COMPARABLE = noexcept(std::declval<const Type&>() == std::declval<const Type&>());
+
+template <typename Type>
+inline constexpr bool IS_NOTHROW_LESS_COMPARABLE = noexcept(std::declval<const Type&>() < std::declval<const Type&>());
+
+//какое отношение ищется между элементами: равенство (operator==) или эквивалентность
+//в смысле operator< (ни один не меньше другого; для NaN выполняется всегда)
+enum class ElementRelation {
+    EQUAL,
+    EQUIVALENT,
+};
+
+template <ElementRelation RELATION, typename Type>
+bool ElementsDiffer(Type lhs, Type rhs) {
+    if constexpr (RELATION == ElementRelation::EQUAL) {
+        return !(lhs == rhs);
+    } else {
+        return lhs < rhs || rhs < lhs;
+    }
+}
+
+//накопитель ширины элемента, чтобы сравнения шли в векторных регистрах без переупаковки
+template <typename Type>
+using CompareMask = std::conditional_t<sizeof(Type) == 8, std::uint64_t,
+                    std::conditional_t<sizeof(Type) == 4, std::uint32_t,
+                    std::conditional_t<sizeof(Type) == 2, std::uint16_t, std::uint8_t>>>;
+
+//есть ли в блоке из COMPARE_BLOCK_SIZE пар различающаяся
+template <ElementRelation RELATION, typename Type>
+bool BlockDiffers(const Type* lhs, const Type* rhs) {
+#ifdef __SSE2__
+    //сравнения SSE2 с порядком (lt, gt) ложны для NaN, а neq для NaN истинно - как операторы C++
+    if constexpr (std::is_same_v<Type, double>) {
+        __m128d differs = _mm_setzero_pd();
+        for (size_t i = 0; i < COMPARE_BLOCK_SIZE; i += 2) {
+            const __m128d l = _mm_loadu_pd(lhs + i);
+            const __m128d r = _mm_loadu_pd(rhs + i);
+            if constexpr (RELATION == ElementRelation::EQUAL) {
+                differs = _mm_or_pd(differs, _mm_cmpneq_pd(l, r));
+            } else {
+                differs = _mm_or_pd(differs, _mm_or_pd(_mm_cmplt_pd(l, r), _mm_cmpgt_pd(l, r)));
+            }
+        }
+        return _mm_movemask_pd(differs) != 0;
+    } else if constexpr (std::is_same_v<Type, float>) {
+        __m128 differs = _mm_setzero_ps();
+        for (size_t i = 0; i < COMPARE_BLOCK_SIZE; i += 4) {
+            const __m128 l = _mm_loadu_ps(lhs + i);
+            const __m128 r = _mm_loadu_ps(rhs + i);
+            if constexpr (RELATION == ElementRelation::EQUAL) {
+                differs = _mm_or_ps(differs, _mm_cmpneq_ps(l, r));
+            } else {
+                differs = _mm_or_ps(differs, _mm_or_ps(_mm_cmplt_ps(l, r), _mm_cmpgt_ps(l, r)));
+            }
+        }
+        return _mm_movemask_ps(differs) != 0;
+    } else
+#endif
+    {
+        CompareMask<Type> differs = 0;
+        for (size_t i = 0; i < COMPARE_BLOCK_SIZE; ++i) {
+            differs |= static_cast<CompareMask<Type>>(ElementsDiffer<RELATION>(lhs[i], rhs[i]));
+        }
+        return differs != 0;
+    }
+}
+
+//индекс первой различающейся пары или count
+template <ElementRelation RELATION, typename Type>
+size_t FindFirstDifference(const Type* lhs, const Type* rhs, size_t count) {
+    size_t i = 0;
+    for (; i + COMPARE_BLOCK_SIZE <= count; i += COMPARE_BLOCK_SIZE) {
+        if (BlockDiffers<RELATION>(lhs + i, rhs + i)) {
+            break;
+        }
+    }
+    for (; i < count; ++i) {
+        if (ElementsDiffer<RELATION>(lhs[i], rhs[i])) {
+            break;
+        }
+    }
+    return i;
+}
+
+template <typename Type>
+bool EqualElements(const Type* lhs, const Type* rhs, size_t count) {
+    if constexpr (IS_BITWISE_COMPARABLE<Type>) {
+        return count == 0 || std::memcmp(lhs, rhs, count * sizeof(Type)) == 0;
+    } else if constexpr (std::is_arithmetic_v<Type>) {
+        return FindFirstDifference<ElementRelation::EQUAL>(lhs, rhs, count) == count;
+    } else {
+        return std::equal(lhs, lhs + count, rhs);
+    }
+}
+
+//то же, что std::lexicographical_compare: эквивалентные элементы (в том числе NaN с чем угодно
+//и +0 с -0) пропускаются, порядок задаёт первая пара неэквивалентных
+template <typename Type>
+bool LessElements(const Type* lhs, size_t lhs_count, const Type* rhs, size_t rhs_count) {
+    const size_t common_count = std::min(lhs_count, rhs_count);
+    if constexpr (IS_BYTEWISE_ORDERED<Type>) {
+        const int result = common_count == 0 ? 0 : std::memcmp(lhs, rhs, common_count);
+        return result != 0 ? result < 0 : lhs_count < rhs_count;
+    } else if constexpr (std::is_arithmetic_v<Type>) {
+        const size_t index = FindFirstDifference<ElementRelation::EQUIVALENT>(lhs, rhs, common_count);
+        return index != common_count ? lhs[index] < rhs[index] : lhs_count < rhs_count;
+    } else {
+        return std::lexicographical_compare(lhs, lhs + lhs_count, rhs, rhs + rhs_count);
+    }
+}
@@ -1,5 +1,647 @@
+#include "mapped_vector.h"
 #include "simple_vector.h"
+#include "small_vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <execution>
+#include <filesystem>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+//Замеры SmallVector против SimpleVector и std::vector на коротких векторах.
+//Каждый сценарий создаёт вектор, заполняет его count элементами, копирует и обходит копию;
+//выводится время на один вектор в наносекундах (CSV: сценарий,контейнер,элементов,ns).
+//Сценарий insert_range вставляет блоки по CHUNK_SIZE элементов в середину большого вектора:
+//поэлементно и одним диапазоном; выводится время построения всего вектора.
+//Сценарии parallel_* сравнивают перегрузки SimpleVector с std::execution::seq и par
+//на большом массиве (время операции целиком).
+//Сценарии compare_* сравнивают два равных вектора операторами SimpleVector и обобщёнными
+//std::equal/std::lexicographical_compare (время одного сравнения).
+//Перед замерами проверяются (assert) MappedVector во временном файле, вставка и удаление диапазонов,
+//строгая гарантия при перевыделении, распространение распределителя, хранение SmallVector,
+//перегрузки с политикой выполнения и блочные сравнения
+
+namespace {
+
+constexpr size_t INLINE_CAPACITY = 8;
+constexpr size_t TOTAL_ELEMENTS = 4'000'000;
+constexpr size_t CHUNK_SIZE = 64;
+constexpr size_t LARGE_ARRAY_SIZE = 16'000'000;
+constexpr size_t COMPARED_SIZE = 65'536;
+constexpr size_t COMPARE_REPEAT_COUNT = 2'000;
+
+template <typename Type>
+void Append(vector<Type>& values, Type value) {
+    values.push_back(value);
+}
+
+template <typename Vector, typename Type>
+void Append(Vector& values, Type value) {
+    values.PushBack(value);
+}
+
+template <typename Vector>
+uint64_t FillCopyAndSum(size_t count) {
+    Vector values;
+    for (size_t i = 0; i < count; ++i) {
+        Append(values, uint64_t{ i });
+    }
+    const Vector copy = values;
+    uint64_t sum = 0;
+    for (const auto& value : copy) {
+        sum += value;
+    }
+    return sum;
+}
+
+template <typename Vector>
+void Measure(const string& container, size_t count) {
+    const size_t iterations = TOTAL_ELEMENTS / count;
+    uint64_t checksum = 0;
+    const auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        checksum += FillCopyAndSum<Vector>(count);
+    }
+    const auto end = chrono::steady_clock::now();
+    const double ns = chrono::duration<double, nano>(end - start).count() / iterations;
+    cout << "fill_copy_sum,"s << container << ',' << count << ',' << ns << endl;
+    if (checksum == 1) {
+        cerr << checksum;
+    }
+}
+
+template <typename Type>
+void InsertChunk(vector<Type>& values, const vector<Type>& chunk) {
+    values.insert(values.begin() + values.size() / 2, chunk.begin(), chunk.end());
+}
+
+template <typename Type>
+void InsertChunk(SimpleVector<Type>& values, const vector<Type>& chunk) {
+    values.Insert(values.begin() + values.GetSize() / 2, chunk.begin(), chunk.end());
+}
+
+//прежний способ: по одному элементу, каждый со своим сдвигом хвоста
+template <typename Type>
+void InsertChunkByElement(SimpleVector<Type>& values, const vector<Type>& chunk) {
+    auto pos = values.begin() + values.GetSize() / 2;
+    for (const Type& value : chunk) {
+        pos = values.Insert(pos, value) + 1;
+    }
+}
+
+template <typename Vector, typename Inserter>
+void MeasureInsert(const string& container, size_t count, Inserter insert) {
+    const vector<uint64_t> chunk(CHUNK_SIZE, 1);
+    Vector values;
+    const auto start = chrono::steady_clock::now();
+    for (size_t inserted = 0; inserted < count; inserted += CHUNK_SIZE) {
+        insert(values, chunk);
+    }
+    const auto end = chrono::steady_clock::now();
+    const double ns = chrono::duration<double, nano>(end - start).count();
+    cout << "insert_range,"s << container << ',' << count << ',' << ns << endl;
+}
+
+template <typename Operation>
+void MeasureOperation(const string& scenario, const string& container, Operation operation) {
+    const auto start = chrono::steady_clock::now();
+    operation();
+    const auto end = chrono::steady_clock::now();
+    const double ns = chrono::duration<double, nano>(end - start).count();
+    cout << scenario << ',' << container << ',' << LARGE_ARRAY_SIZE << ',' << ns << endl;
+}
+
+template <typename ExecutionPolicy>
+void MeasureParallel(const string& policy_name, const ExecutionPolicy& policy) {
+    const string container = "SimpleVector "s + policy_name;
+    SimpleVector<uint64_t> values;
+    MeasureOperation("parallel_construct"s, container, [&] {
+        values = SimpleVector<uint64_t>(policy, LARGE_ARRAY_SIZE, 1);
+    });
+    MeasureOperation("parallel_fill"s, container, [&] {
+        values.Fill(policy, 2);
+    });
+    SimpleVector<uint64_t> copy;
+    MeasureOperation("parallel_copy"s, container, [&] {
+        copy = SimpleVector<uint64_t>(policy, values);
+    });
+    bool equal = false;
+    MeasureOperation("parallel_equal"s, container, [&] {
+        equal = Equal(policy, values, copy);
+    });
+    MeasureOperation("parallel_reserve"s, container, [&] {
+        values.Reserve(policy, LARGE_ARRAY_SIZE * 2);
+    });
+    MeasureOperation("parallel_resize"s, container, [&] {
+        values.Resize(policy, LARGE_ARRAY_SIZE * 2);
+    });
+    if (!equal) {
+        cerr << "copies differ"s << endl;
+    }
+}
+
+template <typename Compare>
+void MeasureCompare(const string& scenario, const string& container, Compare compare) {
+    size_t true_count = 0;
+    const auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < COMPARE_REPEAT_COUNT; ++i) {
+        true_count += compare() ? 1 : 0;
+    }
+    const auto end = chrono::steady_clock::now();
+    const double ns = chrono::duration<double, nano>(end - start).count() / COMPARE_REPEAT_COUNT;
+    cout << scenario << ',' << container << ',' << COMPARED_SIZE << ',' << ns << endl;
+    if (true_count == 1) {
+        cerr << true_count;
+    }
+}
+
+template <typename Type>
+void MeasureCompares(const string& type_name) {
+    SimpleVector<Type> lhs(COMPARED_SIZE);
+    for (size_t i = 0; i < COMPARED_SIZE; ++i) {
+        lhs[i] = static_cast<Type>(i % 100);
+    }
+    const SimpleVector<Type> rhs = lhs;
+    //сравнение через const volatile указатель не даёт компилятору вынести результат из цикла
+    const SimpleVector<Type>* const volatile lhs_ptr = &lhs;
+    MeasureCompare("compare_equal"s, type_name + " generic"s, [&] {
+        return equal(lhs_ptr->begin(), lhs_ptr->end(), rhs.begin(), rhs.end());
+    });
+    MeasureCompare("compare_equal"s, type_name + " SimpleVector"s, [&] {
+        return *lhs_ptr == rhs;
+    });
+    MeasureCompare("compare_less"s, type_name + " generic"s, [&] {
+        return lexicographical_compare(lhs_ptr->begin(), lhs_ptr->end(), rhs.begin(), rhs.end());
+    });
+    MeasureCompare("compare_less"s, type_name + " SimpleVector"s, [&] {
+        return *lhs_ptr < rhs;
+    });
+}
+
+template <typename Operation>
+bool ThrowsLogicError(Operation operation) {
+    try {
+        operation();
+    } catch (const logic_error&) {
+        return true;
+    }
+    return false;
+}
+
+void CheckMappedVector() {
+    const string path = (filesystem::temp_directory_path() / "mapped_vector_check.bin").string();
+    remove(path.c_str());
+    {
+        MappedVector<uint32_t> values(path);
+        assert(values.IsEmpty() && !values.IsReadOnly());
+        for (uint32_t i = 0; i < 1'000; ++i) {
+            values.PushBack(i);
+        }
+        assert(values.GetSize() == 1'000 && values.GetCapacity() >= 1'000);
+        const uint32_t inserted[] = {7, 8, 9};
+        values.Insert(values.cbegin() + 1, begin(inserted), end(inserted));
+        values.Erase(values.cbegin() + 4);
+        assert(values[0] == 0 && values[1] == 7 && values[3] == 9 && values[4] == 2);
+        values.Sync();
+    }
+    {
+        //после повторного открытия элементы берутся прямо из файла
+        MappedVector<uint32_t> values(path);
+        assert(values.GetSize() == 1'002 && values[1] == 7 && values[1'001] == 999);
+        values.Resize(2'000);
+        assert(values[1'999] == 0);
+        values.Resize(1'002);
+    }
+    {
+        MappedVector<uint32_t> values(path, MappedVectorMode::READ_ONLY);
+        assert(values.IsReadOnly() && values.GetSize() == 1'002);
+        uint64_t sum = 0;
+        for (const uint32_t value : as_const(values)) {
+            sum += value;
+        }
+        assert(sum == 999ULL * 1'000 / 2 + 7 + 8 + 9 - 1);
+        assert(as_const(values).At(1) == 7 && as_const(values)[2] == 8);
+        assert(ThrowsLogicError([&values] { values.PushBack(1); }));
+        assert(ThrowsLogicError([&values] { values.Erase(values.cbegin()); }));
+        assert(ThrowsLogicError([&values] { values.Clear(); }));
+        //неконстантный доступ к элементам дал бы указатель в защищённую от записи память
+        assert(ThrowsLogicError([&values] { values[0] = 1; }));
+        assert(ThrowsLogicError([&values] { values.At(0) = 1; }));
+        assert(ThrowsLogicError([&values] { values.begin(); }));
+        assert(ThrowsLogicError([&values] { values.end(); }));
+        assert(values.GetSize() == 1'002 && as_const(values)[0] == 0);
+    }
+    {
+        //размер элемента в заголовке не совпадает с uint64_t
+        bool rejected = false;
+        try {
+            MappedVector<uint64_t> values(path, MappedVectorMode::READ_ONLY);
+        } catch (const invalid_argument&) {
+            rejected = true;
+        }
+        assert(rejected);
+    }
+    remove(path.c_str());
+}
+
+//диапазон [first, first + count) значений make_value
+template <typename MakeValue>
+auto MakeValues(MakeValue make_value, int first, int count) {
+    vector<decltype(make_value(0))> values;
+    for (int i = 0; i < count; ++i) {
+        values.push_back(make_value(first + i));
+    }
+    return values;
+}
+
+//те же вставки и удаления диапазонов, что и у std::vector: в пустой вектор, с хвостом длиннее
+//и короче диапазона (ветви сдвига хвоста), в конец, пустой диапазон, с ростом буфера
+template <typename Vector, typename MakeValue>
+void CheckRangeInsertErase(MakeValue make_value) {
+    Vector values;
+    vector<decltype(make_value(0))> expected;
+    const auto check = [&values, &expected] {
+        assert(values.GetSize() == expected.size() && equal(values.begin(), values.end(), expected.begin()));
+    };
+    const auto insert = [&](size_t index, int first, int count) {
+        const auto items = MakeValues(make_value, first, count);
+        expected.insert(expected.begin() + index, items.begin(), items.end());
+        const auto it = values.Insert(values.cbegin() + index, items.begin(), items.end());
+        assert(it == values.begin() + index);
+        check();
+    };
+    const auto erase = [&](size_t index, size_t count) {
+        expected.erase(expected.begin() + index, expected.begin() + index + count);
+        const auto it = values.Erase(values.cbegin() + index, values.cbegin() + index + count);
+        assert(it == values.begin() + index);
+        check();
+    };
+    insert(0, 0, 3);
+    insert(1, 10, 1);
+    insert(2, 20, 5);
+    values.Reserve(64);
+    const auto* data = values.begin();
+    insert(values.GetSize(), 30, 2);
+    insert(3, 40, 0);
+    insert(1, 50, 2);
+    insert(4, 60, 20);
+    //вставки в пределах резерва не перевыделяют буфер
+    assert(values.begin() == data);
+    insert(6, 80, 80);
+    erase(2, 7);
+    erase(0, 0);
+    erase(10, values.GetSize() - 10);
+    erase(0, values.GetSize());
+
+    //список инициализации и однопроходный диапазон
+    values.Insert(values.cbegin(), {make_value(1), make_value(2)});
+    expected = MakeValues(make_value, 1, 2);
+    check();
+    istringstream in("3 4 5"s);
+    using Type = decltype(make_value(0));
+    values.Insert(values.cbegin() + 1, istream_iterator<Type>(in), istream_iterator<Type>());
+    expected.insert(expected.begin() + 1, {make_value(3), make_value(4), make_value(5)});
+    check();
+}
+
+//подсчитывает живые объекты и по команде бросает исключение из копирующего конструктора.
+//Перемещение не noexcept, поэтому при переносе в новый буфер элементы копируются
+struct Fragile {
+    static inline int live_count = 0;
+    //сколько копий ещё можно создать до исключения; -1 - без ограничений
+    static inline int copies_before_throw = -1;
+
+    string value;
+
+    Fragile(int number) : value(to_string(number)) {
+        ++live_count;
+    }
+
+    Fragile(const Fragile& other) : value(other.value) {
+        if (copies_before_throw == 0) {
+            throw runtime_error("copy failed"s);
+        }
+        if (copies_before_throw > 0) {
+            --copies_before_throw;
+        }
+        ++live_count;
+    }
+
+    Fragile(Fragile&& other) : value(move(other.value)) {
+        ++live_count;
+    }
+
+    Fragile& operator=(const Fragile&) = default;
+    Fragile& operator=(Fragile&&) = default;
+
+    ~Fragile() {
+        --live_count;
+    }
+
+    bool operator==(const Fragile& other) const {
+        return value == other.value;
+    }
+};
+
+//при ошибке копирования во время перевыделения буфера вектор остаётся прежним
+template <typename Vector>
+void CheckStrongGuarantee() {
+    {
+        Vector values;
+        for (int i = 0; i < 4; ++i) {
+            values.PushBack(i);
+        }
+        values.Reserve(4);
+        const Vector original = values;
+        const auto* data = values.begin();
+        const size_t capacity = values.GetCapacity();
+        const auto fails = [&values, &original, data, capacity](int copies_before_throw, auto operation) {
+            Fragile::copies_before_throw = copies_before_throw;
+            bool thrown = false;
+            try {
+                operation();
+            } catch (const runtime_error&) {
+                thrown = true;
+            }
+            Fragile::copies_before_throw = -1;
+            assert(thrown && values == original && values.begin() == data && values.GetCapacity() == capacity);
+        };
+        const vector<Fragile> items = {10, 11, 12};
+        //ошибка при копировании вставляемых элементов и при переносе старых
+        for (const int copies : {0, 2, 3, 5}) {
+            fails(copies, [&values, &items] { values.Insert(values.cbegin() + 2, items.begin(), items.end()); });
+        }
+        for (const int copies : {0, 1, 4}) {
+            fails(copies, [&values, &items] { values.PushBack(items[0]); });
+            fails(copies, [&values, &items] { values.Insert(values.cbegin() + 1, items[1]); });
+        }
+        for (const int copies : {0, 3}) {
+            fails(copies, [&values] { values.Reserve(100); });
+        }
+    }
+    assert(Fragile::live_count == 0);
+}
+
+//распределитель с состоянием: равны только распределители с одним id,
+//живые выделения каждого id считаются в outstanding
+template <typename Type, bool PROPAGATE>
+struct TrackingAllocator {
+    using value_type = Type;
+    using propagate_on_container_copy_assignment = bool_constant<PROPAGATE>;
+    using propagate_on_container_move_assignment = bool_constant<PROPAGATE>;
+    using propagate_on_container_swap = bool_constant<PROPAGATE>;
+
+    static inline int outstanding[4] = {};
+
+    int id = 0;
+
+    explicit TrackingAllocator(int allocator_id) : id(allocator_id) {
+    }
+
+    template <typename Other>
+    TrackingAllocator(const TrackingAllocator<Other, PROPAGATE>& other) : id(other.id) {
+    }
+
+    Type* allocate(size_t count) {
+        ++outstanding[id];
+        return allocator<Type>().allocate(count);
+    }
+
+    void deallocate(Type* pointer, size_t count) {
+        --outstanding[id];
+        allocator<Type>().deallocate(pointer, count);
+    }
+
+    template <typename Other>
+    struct rebind {
+        using other = TrackingAllocator<Other, PROPAGATE>;
+    };
+
+    bool operator==(const TrackingAllocator& other) const {
+        return id == other.id;
+    }
+
+    bool operator!=(const TrackingAllocator& other) const {
+        return id != other.id;
+    }
+};
+
+template <bool PROPAGATE>
+void CheckAllocatorPropagation() {
+    using Allocator = TrackingAllocator<string, PROPAGATE>;
+    using Vector = SimpleVector<string, Allocator>;
+    {
+        Vector first({"a"s, "b"s}, Allocator(1));
+        Vector second({"c"s}, Allocator(2));
+
+        //копия берёт распределитель через select_on_container_copy_construction (по умолчанию тот же)
+        const Vector copy = first;
+        assert(copy.GetAllocator().id == 1 && copy == first);
+
+        Vector copy_assigned(Allocator(3));
+        copy_assigned = second;
+        assert(copy_assigned.GetAllocator().id == (PROPAGATE ? 2 : 3) && copy_assigned == second);
+
+        //без распространения при разных распределителях элементы перемещаются по одному
+        Vector move_assigned({"x"s}, Allocator(3));
+        const string* second_data = second.begin();
+        move_assigned = move(second);
+        assert(move_assigned.GetSize() == 1 && move_assigned[0] == "c"s && second.IsEmpty());
+        assert(move_assigned.GetAllocator().id == (PROPAGATE ? 2 : 3));
+        assert((move_assigned.begin() == second_data) == PROPAGATE);
+
+        //без распространения обмениваться могут только векторы с равными распределителями
+        Vector other({"d"s, "e"s, "f"s}, Allocator(PROPAGATE ? 2 : 1));
+        first.swap(other);
+        assert(first.GetSize() == 3 && other.GetSize() == 2 && other[1] == "b"s);
+        assert(first.GetAllocator().id == (PROPAGATE ? 2 : 1) && other.GetAllocator().id == 1);
+    }
+    //каждый буфер освобождён тем же распределителем, которым выделен
+    for (const int count : Allocator::outstanding) {
+        assert(count == 0);
+    }
+}
+
+//переходы SmallVector между встроенным буфером и кучей при копировании, перемещении и обмене
+void CheckSmallVectorStorage() {
+    using Vector = SmallVector<Fragile, 4>;
+    const auto make = [](int first, int count) {
+        Vector values;
+        for (int i = 0; i < count; ++i) {
+            values.PushBack(first + i);
+        }
+        return values;
+    };
+    const auto has = [](const Vector& values, int first, int count) {
+        if (values.GetSize() != static_cast<size_t>(count)) {
+            return false;
+        }
+        for (int i = 0; i < count; ++i) {
+            if (!(values[i] == Fragile(first + i))) {
+                return false;
+            }
+        }
+        return true;
+    };
+    {
+        const Vector small = make(0, 3);
+        const Vector large = make(100, 10);
+        assert(small.IsInline() && !large.IsInline());
+
+        //копирование: в кучу из встроенного буфера и обратно, в свой буфер без перевыделения
+        Vector copy = large;
+        assert(has(copy, 100, 10) && !copy.IsInline());
+        copy = small;
+        assert(has(copy, 0, 3) && !copy.IsInline());
+        Vector inline_copy = small;
+        assert(inline_copy.IsInline());
+        inline_copy = large;
+        assert(has(inline_copy, 100, 10) && !inline_copy.IsInline());
+
+        //перемещение из кучи забирает буфер, из встроенного буфера - поэлементно
+        Vector heap_source = make(200, 6);
+        const Fragile* heap_data = heap_source.begin();
+        Vector moved(move(heap_source));
+        assert(moved.begin() == heap_data && has(moved, 200, 6) && heap_source.IsEmpty() && heap_source.IsInline());
+        Vector inline_source = make(300, 2);
+        Vector moved_inline(move(inline_source));
+        assert(moved_inline.IsInline() && has(moved_inline, 300, 2) && inline_source.IsEmpty());
+        moved_inline = move(moved);
+        assert(moved_inline.begin() == heap_data && has(moved_inline, 200, 6) && moved.IsEmpty());
+        moved = make(400, 1);
+        assert(moved.IsInline() && has(moved, 400, 1));
+
+        //обмен всех сочетаний
+        Vector a = make(0, 2);
+        Vector b = make(10, 7);
+        a.swap(b);
+        assert(has(a, 10, 7) && !a.IsInline() && has(b, 0, 2));
+        Vector c = make(20, 5);
+        a.swap(c);
+        assert(has(a, 20, 5) && has(c, 10, 7));
+        Vector d = make(30, 3);
+        b.swap(d);
+        assert(has(b, 30, 3) && has(d, 0, 2) && b.IsInline() && d.IsInline());
+        Vector e;
+        e.swap(c);
+        assert(has(e, 10, 7) && c.IsEmpty());
+    }
+    assert(Fragile::live_count == 0);
+}
+
+//перегрузки с политикой выполнения дают тот же результат, что и последовательные
+template <typename Type, typename MakeValue>
+void CheckPolicyOverloads(MakeValue make_value) {
+    const auto check_policy = [&make_value](const auto& policy) {
+        const SimpleVector<Type> filled(policy, 1'000, make_value(7));
+        assert(filled == SimpleVector<Type>(1'000, make_value(7)));
+        SimpleVector<Type> copy(policy, filled);
+        assert(copy == filled);
+        copy.Resize(policy, 3'000);
+        assert(copy.GetSize() == 3'000 && copy[2'999] == Type{} && copy[999] == make_value(7));
+        copy.Reserve(policy, 10'000);
+        assert(copy.GetCapacity() == 10'000 && copy[0] == make_value(7));
+        copy.Fill(policy, make_value(3));
+        assert(all_of(copy.begin(), copy.end(), [&make_value](const Type& value) { return value == make_value(3); }));
+        copy.Resize(policy, 10);
+        assert(copy.GetSize() == 10);
+
+        SimpleVector<Type> other = copy;
+        assert(Equal(policy, copy, other) && !LexicographicalCompare(policy, copy, other));
+        other[9] = make_value(9);
+        assert(!Equal(policy, copy, other));
+        assert(LexicographicalCompare(policy, copy, other) == (copy < other));
+        other.Resize(5);
+        assert(!Equal(policy, copy, other) && LexicographicalCompare(policy, other, copy));
+    };
+    check_policy(execution::seq);
+    check_policy(execution::par);
+    check_policy(execution::par_unseq);
+}
+
+//блочные сравнения совпадают с std::equal и std::lexicographical_compare,
+//в том числе когда различие внутри блока, на его границе и в остатке после блоков
+template <typename Type>
+void CheckCompareKernels(const vector<Type>& special_values) {
+    mt19937 generator(5);
+    for (size_t size = 0; size <= 3 * COMPARE_BLOCK_SIZE + 5; ++size) {
+        SimpleVector<Type> lhs(size);
+        for (size_t i = 0; i < size; ++i) {
+            lhs[i] = static_cast<Type>(generator() % 5);
+        }
+        for (size_t position = 0; position <= size; ++position) {
+            for (const Type value : special_values) {
+                SimpleVector<Type> rhs = lhs;
+                if (position < size) {
+                    rhs[position] = value;
+                } else {
+                    rhs.PushBack(value);
+                }
+                for (const auto& [left, right] : {pair{&lhs, &rhs}, pair{&rhs, &lhs}, pair{&rhs, &rhs}}) {
+                    const bool expected_equal = equal(left->begin(), left->end(), right->begin(), right->end());
+                    const bool expected_less = lexicographical_compare(left->begin(), left->end(), right->begin(), right->end());
+                    assert((*left == *right) == expected_equal);
+                    assert((*left < *right) == expected_less);
+                    assert(Equal(execution::par, *left, *right) == expected_equal);
+                    assert(LexicographicalCompare(execution::par, *left, *right) == expected_less);
+                }
+            }
+        }
+    }
+}
+
+}
 
 int main() {
+    CheckMappedVector();
+    CheckRangeInsertErase<SimpleVector<int>>([](int value) { return value; });
+    CheckRangeInsertErase<SimpleVector<string>>([](int value) { return to_string(value); });
+    CheckRangeInsertErase<SmallVector<int, 4>>([](int value) { return value; });
+    CheckRangeInsertErase<SmallVector<string, 4>>([](int value) { return to_string(value); });
+    CheckRangeInsertErase<SmallVector<string, 16>>([](int value) { return to_string(value); });
+    CheckStrongGuarantee<SimpleVector<Fragile>>();
+    CheckStrongGuarantee<SmallVector<Fragile, 4>>();
+    CheckAllocatorPropagation<true>();
+    CheckAllocatorPropagation<false>();
+    CheckSmallVectorStorage();
+    CheckPolicyOverloads<uint64_t>([](int value) { return static_cast<uint64_t>(value); });
+    CheckPolicyOverloads<string>([](int value) { return to_string(value); });
+    CheckCompareKernels<uint8_t>({0, 1, 4, 200, 255});
+    CheckCompareKernels<uint32_t>({0, 1, 4, 4'000'000'000u});
+    CheckCompareKernels<int64_t>({-1, 0, 4, INT64_MIN, INT64_MAX});
+    CheckCompareKernels<double>({-1.0, 0.0, -0.0, 4.0, numeric_limits<double>::infinity(), numeric_limits<double>::quiet_NaN()});
+    for (const size_t count : {1, 2, 4, 8, 16, 64}) {
+        Measure<vector<uint64_t>>("std::vector"s, count);
+        Measure<SimpleVector<uint64_t>>("SimpleVector"s, count);
+        Measure<SmallVector<uint64_t, INLINE_CAPACITY>>("SmallVector<8>"s, count);
+    }
+    for (const size_t count : {1'024, 16'384, 131'072}) {
+        MeasureInsert<vector<uint64_t>>("std::vector"s, count,
+                                        [](auto& values, const auto& chunk) { InsertChunk(values, chunk); });
+        MeasureInsert<SimpleVector<uint64_t>>("SimpleVector"s, count,
+                                              [](auto& values, const auto& chunk) { InsertChunk(values, chunk); });
+        MeasureInsert<SimpleVector<uint64_t>>("SimpleVector by element"s, count,
+                                              [](auto& values, const auto& chunk) { InsertChunkByElement(values, chunk); });
+    }
+    MeasureParallel("seq"s, execution::seq);
+    MeasureParallel("par"s, execution::par);
+    MeasureCompares<uint8_t>("uint8_t"s);
+    MeasureCompares<uint32_t>("uint32_t"s);
+    MeasureCompares<int64_t>("int64_t"s);
+    MeasureCompares<double>("double"s);
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,388 @@
+#pragma once
+
+#include "raw_memory.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+enum class MappedVectorMode {
+    READ_WRITE, //файл создаётся, если его нет
+    READ_ONLY,  //изменения запрещены, файл должен существовать
+};
+
+//Файл с элементами вектора, отображённый в память (MAP_SHARED).
+//В начале файла - заголовок с размером вектора, за ним - ячейки под capacity элементов.
+//Рост - ftruncate файла и mremap отображения; изменения попадают в файл без явной записи,
+//Sync дожидается их сброса на диск. Файл READ_ONLY отображается только для чтения (PROT_READ)
+template <typename Type>
+class MappedStorage {
+public:
+    //заголовок занимает HEADER_SIZE байт, чтобы элементы были выровнены
+    static constexpr size_t HEADER_SIZE = 64;
+
+    static_assert(std::is_trivially_copyable_v<Type>, "MappedStorage stores only trivially copyable types");
+    static_assert(alignof(Type) <= HEADER_SIZE, "Type alignment exceeds MappedStorage header size");
+
+    MappedStorage(const std::string& path, MappedVectorMode mode)
+            : read_only_(mode == MappedVectorMode::READ_ONLY) {
+        fd_ = read_only_ ? open(path.c_str(), O_RDONLY) : open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd_ < 0) {
+            throw std::runtime_error("Cannot open " + path);
+        }
+        try {
+            Open(path);
+        } catch (...) {
+            Close();
+            throw;
+        }
+    }
+
+    MappedStorage(const MappedStorage&) = delete;
+    MappedStorage& operator=(const MappedStorage&) = delete;
+
+    MappedStorage(MappedStorage&& other) noexcept
+            : fd_(std::exchange(other.fd_, -1))
+            , mapping_(std::exchange(other.mapping_, nullptr))
+            , mapping_size_(std::exchange(other.mapping_size_, 0))
+            , read_only_(other.read_only_) {
+    }
+
+    MappedStorage& operator=(MappedStorage&& rhs) noexcept {
+        if (this != &rhs) {
+            Close();
+            fd_ = std::exchange(rhs.fd_, -1);
+            mapping_ = std::exchange(rhs.mapping_, nullptr);
+            mapping_size_ = std::exchange(rhs.mapping_size_, 0);
+            read_only_ = rhs.read_only_;
+        }
+        return *this;
+    }
+
+    ~MappedStorage() {
+        Close();
+    }
+
+    Type* GetAddress() noexcept {
+        return reinterpret_cast<Type*>(mapping_ + HEADER_SIZE);
+    }
+
+    const Type* GetAddress() const noexcept {
+        return reinterpret_cast<const Type*>(mapping_ + HEADER_SIZE);
+    }
+
+    size_t GetCapacity() const noexcept {
+        return (mapping_size_ - HEADER_SIZE) / sizeof(Type);
+    }
+
+    //размер вектора хранится в заголовке файла
+    size_t GetSize() const noexcept {
+        return static_cast<size_t>(GetHeader().size);
+    }
+
+    void SetSize(size_t size) noexcept {
+        assert(!read_only_ && size <= GetCapacity());
+        GetHeader().size = size;
+    }
+
+    bool IsReadOnly() const noexcept {
+        return read_only_;
+    }
+
+    //увеличивает файл и отображение до new_capacity элементов; адрес элементов может измениться
+    void Grow(size_t new_capacity) {
+        assert(!read_only_ && new_capacity > GetCapacity());
+        const size_t new_size = HEADER_SIZE + new_capacity * sizeof(Type);
+        if (ftruncate(fd_, static_cast<off_t>(new_size)) != 0) {
+            throw std::runtime_error("Cannot resize mapped file");
+        }
+#ifdef __linux__
+        void* mapping = mremap(mapping_, mapping_size_, new_size, MREMAP_MAYMOVE);
+        if (mapping == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+#else
+        void* mapping = Map(new_size);
+        munmap(mapping_, mapping_size_);
+#endif
+        mapping_ = static_cast<char*>(mapping);
+        mapping_size_ = new_size;
+    }
+
+    //синхронно сбрасывает изменённые страницы на диск
+    void Sync() {
+        if (!read_only_ && msync(mapping_, mapping_size_, MS_SYNC) != 0) {
+            throw std::runtime_error("Cannot sync mapped file");
+        }
+    }
+
+private:
+    static constexpr uint64_t MAGIC = 0x31524f5456504d4dULL; //"MMPVTOR1"
+
+    struct Header {
+        uint64_t magic;
+        uint64_t element_size;
+        uint64_t size;
+    };
+
+    int fd_ = -1;
+    char* mapping_ = nullptr;
+    size_t mapping_size_ = 0;
+    bool read_only_ = false;
+
+    Header& GetHeader() noexcept {
+        return *reinterpret_cast<Header*>(mapping_);
+    }
+
+    const Header& GetHeader() const noexcept {
+        return *reinterpret_cast<const Header*>(mapping_);
+    }
+
+    void Open(const std::string& path) {
+        struct stat file_stat {};
+        if (fstat(fd_, &file_stat) != 0) {
+            throw std::runtime_error("Cannot stat " + path);
+        }
+        size_t file_size = static_cast<size_t>(file_stat.st_size);
+        const bool is_new = file_size == 0 && !read_only_;
+        if (is_new) {
+            file_size = HEADER_SIZE;
+            if (ftruncate(fd_, static_cast<off_t>(file_size)) != 0) {
+                throw std::runtime_error("Cannot resize " + path);
+            }
+        }
+        if (file_size < HEADER_SIZE || (file_size - HEADER_SIZE) % sizeof(Type) != 0) {
+            throw std::invalid_argument(path + " is not a mapped vector file");
+        }
+        mapping_ = static_cast<char*>(Map(file_size));
+        mapping_size_ = file_size;
+        if (is_new) {
+            GetHeader() = Header{ MAGIC, sizeof(Type), 0 };
+        }
+        const Header& header = GetHeader();
+        if (header.magic != MAGIC || header.element_size != sizeof(Type) || header.size > GetCapacity()) {
+            throw std::invalid_argument(path + " is not a mapped vector file of this element type");
+        }
+    }
+
+    void* Map(size_t size) {
+        const int protection = read_only_ ? PROT_READ : PROT_READ | PROT_WRITE;
+        void* mapping = mmap(nullptr, size, protection, MAP_SHARED, fd_, 0);
+        if (mapping == MAP_FAILED) {
+            throw std::runtime_error("Cannot map file");
+        }
+        return mapping;
+    }
+
+    void Close() noexcept {
+        if (mapping_ != nullptr) {
+            munmap(mapping_, mapping_size_);
+            mapping_ = nullptr;
+        }
+        if (fd_ >= 0) {
+            close(fd_);
+            fd_ = -1;
+        }
+    }
+};
+
+//Вектор тривиально копируемых элементов в файле с интерфейсом SimpleVector.
+//Элементы живут прямо в отображении файла: после повторного открытия (в том числе READ_ONLY)
+//вектор доступен без чтения и копирования, страницы подгружаются по обращению.
+//Рост, как у SimpleVector, удваивает ёмкость; указатели и итераторы при росте недействительны.
+//Вектор, открытый READ_ONLY, доступен только через константные методы: изменяющие методы и неконстантные
+//operator[], At, begin и end выбрасывают logic_error. Читать его нужно через константную ссылку (std::as_const)
+template <typename Type>
+class MappedVector {
+public:
+    using Iterator = Type*;
+    using ConstIterator = const Type*;
+
+    explicit MappedVector(const std::string& path, MappedVectorMode mode = MappedVectorMode::READ_WRITE)
+            : storage_(path, mode) {
+    }
+
+    size_t GetSize() const noexcept {
+        return storage_.GetSize();
+    }
+
+    size_t GetCapacity() const noexcept {
+        return storage_.GetCapacity();
+    }
+
+    bool IsEmpty() const noexcept {
+        return GetSize() == 0;
+    }
+
+    bool IsReadOnly() const noexcept {
+        return storage_.IsReadOnly();
+    }
+
+    Type& operator[](size_t index) {
+        CheckWritable();
+        assert(index < GetSize());
+        return storage_.GetAddress()[index];
+    }
+
+    const Type& operator[](size_t index) const noexcept {
+        assert(index < GetSize());
+        return storage_.GetAddress()[index];
+    }
+
+    Type& At(size_t index) {
+        CheckWritable();
+        if (index >= GetSize()) {
+            throw std::out_of_range("index>=size");
+        }
+        return storage_.GetAddress()[index];
+    }
+
+    const Type& At(size_t index) const {
+        if (index >= GetSize()) {
+            throw std::out_of_range("index>=size");
+        }
+        return storage_.GetAddress()[index];
+    }
+
+    Iterator begin() {
+        CheckWritable();
+        return storage_.GetAddress();
+    }
+
+    Iterator end() {
+        return begin() + GetSize();
+    }
+
+    ConstIterator begin() const noexcept {
+        return storage_.GetAddress();
+    }
+
+    ConstIterator end() const noexcept {
+        return begin() + GetSize();
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return begin();
+    }
+
+    ConstIterator cend() const noexcept {
+        return end();
+    }
+
+    void Clear() {
+        CheckWritable();
+        storage_.SetSize(0);
+    }
+
+    void Resize(size_t new_size) {
+        CheckWritable();
+        const size_t size = GetSize();
+        if (new_size > size) {
+            if (new_size > GetCapacity()) {
+                Reserve(std::max(new_size, GetCapacity() * 2));
+            }
+            std::uninitialized_value_construct_n(storage_.GetAddress() + size, new_size - size);
+        }
+        storage_.SetSize(new_size);
+    }
+
+    void Reserve(size_t new_capacity) {
+        CheckWritable();
+        if (new_capacity > GetCapacity()) {
+            storage_.Grow(new_capacity);
+        }
+    }
+
+    void PushBack(const Type& value) {
+        EmplaceBack(value);
+    }
+
+    //значение создаётся до роста: аргументы могут ссылаться на элементы вектора
+    template <typename... Args>
+    Type& EmplaceBack(Args&&... args) {
+        CheckWritable();
+        const Type value(std::forward<Args>(args)...);
+        const size_t size = GetSize();
+        if (size == GetCapacity()) {
+            storage_.Grow(size == 0 ? 1 : size * 2);
+        }
+        Type* slot = storage_.GetAddress() + size;
+        RelocateBytes(&value, 1, slot);
+        storage_.SetSize(size + 1);
+        return *slot;
+    }
+
+    void PopBack() {
+        CheckWritable();
+        if (!IsEmpty()) {
+            storage_.SetSize(GetSize() - 1);
+        }
+    }
+
+    Iterator Insert(ConstIterator pos, const Type& value) {
+        //value может лежать в самом векторе и сдвинуться или переехать при росте
+        const Type copy = value;
+        return Insert(pos, &copy, &copy + 1);
+    }
+
+    //вставляет [first, last) перед pos: файл растёт не больше одного раза, хвост сдвигается memmove.
+    //first и last не должны указывать в сам вектор
+    template <typename ForwardIterator>
+    Iterator Insert(ConstIterator pos, ForwardIterator first, ForwardIterator last) {
+        CheckWritable();
+        assert(pos >= cbegin() && pos <= cend());
+        const size_t index = pos - cbegin();
+        const size_t size = GetSize();
+        const auto count = static_cast<size_t>(std::distance(first, last));
+        if (size + count > GetCapacity()) {
+            storage_.Grow(std::max(size + count, GetCapacity() * 2));
+        }
+        Type* position = storage_.GetAddress() + index;
+        RelocateBytesOverlapping(position, size - index, position + count);
+        std::uninitialized_copy_n(first, count, position);
+        storage_.SetSize(size + count);
+        return position;
+    }
+
+    Iterator Erase(ConstIterator pos) {
+        assert(pos >= cbegin() && pos < cend());
+        return Erase(pos, pos + 1);
+    }
+
+    Iterator Erase(ConstIterator first, ConstIterator last) {
+        CheckWritable();
+        assert(cbegin() <= first && first <= last && last <= cend());
+        const size_t index = first - cbegin();
+        const size_t count = last - first;
+        Type* data = storage_.GetAddress();
+        RelocateBytesOverlapping(data + index + count, GetSize() - index - count, data + index);
+        storage_.SetSize(GetSize() - count);
+        return data + index;
+    }
+
+    //дожидается записи изменений на диск; без вызова они попадут в файл позже, силами ОС
+    void Sync() {
+        storage_.Sync();
+    }
+
+private:
+    MappedStorage<Type> storage_;
+
+    void CheckWritable() const {
+        if (IsReadOnly()) {
+            throw std::logic_error("MappedVector is opened read-only");
+        }
+    }
+};
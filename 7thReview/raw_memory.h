@@ -0,0 +1,157 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+//Объект можно перенести в другую память побайтовым копированием, не вызывая деструктор исходного.
+//По умолчанию так переносятся тривиально копируемые типы; для типов вроде std::unique_ptr,
+//которые не ссылаются на собственный адрес, признак можно включить специализацией
+template <typename Type>
+struct IsTriviallyRelocatable : std::is_trivially_copyable<Type> {
+};
+
+//побайтовый перенос count объектов в неинициализированную память, не пересекающуюся с исходной
+template <typename Type>
+void RelocateBytes(const Type* from, size_t count, Type* to) noexcept {
+    if (count != 0) {
+        std::memcpy(static_cast<void*>(to), static_cast<const void*>(from), count * sizeof(Type));
+    }
+}
+
+//то же для пересекающихся диапазонов (сдвиг элементов внутри буфера)
+template <typename Type>
+void RelocateBytesOverlapping(const Type* from, size_t count, Type* to) noexcept {
+    if (count != 0) {
+        std::memmove(static_cast<void*>(to), static_cast<const void*>(from), count * sizeof(Type));
+    }
+}
+
+//Буфер неинициализированной памяти под capacity объектов Type.
+//Память выделяется распределителем Allocator без вызова конструкторов, созданием и разрушением
+//элементов управляет владелец буфера (SimpleVector) через std::allocator_traits.
+//Распределитель переносится при перемещении и, если это разрешают его свойства
+//propagate_on_container_move_assignment и propagate_on_container_swap, при присваивании и обмене.
+//Распределитель хранится как закрытая база, чтобы пустой std::allocator не увеличивал размер буфера
+template <typename Type, typename Allocator = std::allocator<Type>>
+class RawMemory : private Allocator {
+    using AllocTraits = std::allocator_traits<Allocator>;
+
+public:
+    static_assert(std::is_same_v<typename AllocTraits::value_type, Type>, "Allocator::value_type must be Type");
+    static_assert(std::is_same_v<typename AllocTraits::pointer, Type*>, "RawMemory supports only allocators with raw pointers");
+
+    RawMemory() = default;
+
+    explicit RawMemory(const Allocator& allocator) noexcept
+            : Allocator(allocator) {
+    }
+
+    explicit RawMemory(size_t capacity, const Allocator& allocator = Allocator())
+            : Allocator(allocator), buffer_(Allocate(capacity)), capacity_(capacity) {
+    }
+
+    RawMemory(const RawMemory&) = delete;
+    RawMemory& operator=(const RawMemory&) = delete;
+
+    RawMemory(RawMemory&& other) noexcept
+            : Allocator(std::move(other.GetAllocator()))
+            , buffer_(std::exchange(other.buffer_, nullptr))
+            , capacity_(std::exchange(other.capacity_, 0)) {
+    }
+
+    //без propagate_on_container_move_assignment распределители должны быть равны
+    RawMemory& operator=(RawMemory&& rhs) noexcept {
+        if (this != &rhs) {
+            Deallocate();
+            if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+                GetAllocator() = std::move(rhs.GetAllocator());
+            } else {
+                assert(GetAllocator() == rhs.GetAllocator());
+            }
+            buffer_ = std::exchange(rhs.buffer_, nullptr);
+            capacity_ = std::exchange(rhs.capacity_, 0);
+        }
+        return *this;
+    }
+
+    ~RawMemory() {
+        Deallocate();
+    }
+
+    Type* operator+(size_t offset) noexcept {
+        //адрес сразу за последним элементом тоже допустим
+        assert(offset <= capacity_);
+        return buffer_ + offset;
+    }
+
+    const Type* operator+(size_t offset) const noexcept {
+        return const_cast<RawMemory&>(*this) + offset;
+    }
+
+    Type& operator[](size_t index) noexcept {
+        assert(index < capacity_);
+        return buffer_[index];
+    }
+
+    const Type& operator[](size_t index) const noexcept {
+        return const_cast<RawMemory&>(*this)[index];
+    }
+
+    //распределители обмениваются только при propagate_on_container_swap, иначе должны быть равны
+    void Swap(RawMemory& other) noexcept {
+        if constexpr (AllocTraits::propagate_on_container_swap::value) {
+            using std::swap;
+            swap(GetAllocator(), other.GetAllocator());
+        } else {
+            assert(GetAllocator() == other.GetAllocator());
+        }
+        std::swap(buffer_, other.buffer_);
+        std::swap(capacity_, other.capacity_);
+    }
+
+    //освобождает буфер и заменяет распределитель (распространение при копирующем присваивании)
+    void ResetAllocator(const Allocator& allocator) {
+        Deallocate();
+        buffer_ = nullptr;
+        capacity_ = 0;
+        GetAllocator() = allocator;
+    }
+
+    Type* GetAddress() noexcept {
+        return buffer_;
+    }
+
+    const Type* GetAddress() const noexcept {
+        return buffer_;
+    }
+
+    size_t GetCapacity() const noexcept {
+        return capacity_;
+    }
+
+    Allocator& GetAllocator() noexcept {
+        return *this;
+    }
+
+    const Allocator& GetAllocator() const noexcept {
+        return *this;
+    }
+
+private:
+    Type* buffer_ = nullptr;
+    size_t capacity_ = 0;
+
+    Type* Allocate(size_t n) {
+        return n != 0 ? AllocTraits::allocate(GetAllocator(), n) : nullptr;
+    }
+
+    void Deallocate() noexcept {
+        if (buffer_ != nullptr) {
+            AllocTraits::deallocate(GetAllocator(), buffer_, capacity_);
+        }
+    }
+};
\ No newline at end of file
@@ -1,40 +1,180 @@
 #pragma once
 
 #include <cassert>
-#include "array_ptr.h"
+#include "element_compare.h"
+#include "raw_memory.h"
+#include <algorithm>
+#include <execution>
 #include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
 
 struct ReserveProxyObj {
     explicit ReserveProxyObj(std::size_t size) : capacity_(size) { }
     std::size_t capacity_;
 };
 
-template<typename Type>
+//It - итератор категории Category или более сильной; для не-итераторов (например, int) - false
+template <typename It, typename Category, typename = void>
+struct IsIteratorOfCategory : std::false_type {
+};
+
+template <typename It, typename Category>
+struct IsIteratorOfCategory<It, Category, std::void_t<typename std::iterator_traits<It>::iterator_category>>
+        : std::is_convertible<typename std::iterator_traits<It>::iterator_category, Category> {
+};
+
+template <typename ExecutionPolicy>
+inline constexpr bool IS_SEQUENCED_POLICY = std::is_same_v<std::decay_t<ExecutionPolicy>, std::execution::sequenced_policy>;
+
+//Элементы хранятся в неинициализированном буфере RawMemory: конструируются только
+//элементы [0, size), ячейки резерва остаются сырой памятью.
+//Память выделяется распределителем Allocator, элементы создаются и разрушаются через
+//std::allocator_traits (для std::allocator - стандартными алгоритмами uninitialized_*).
+//Распределитель распространяется при копировании, перемещении и обмене по его свойствам propagate_on_container_*
+template<typename Type, typename Allocator = std::allocator<Type>>
 class SimpleVector {
+    using AllocTraits = std::allocator_traits<Allocator>;
+
+    template <typename It>
+    static constexpr bool IS_FORWARD_ITERATOR = IsIteratorOfCategory<It, std::forward_iterator_tag>::value;
+
+    //отсекает целые аргументы, чтобы SimpleVector(3, 5) оставался конструктором по размеру и значению
+    template <typename It>
+    using EnableIfInputIterator = std::enable_if_t<IsIteratorOfCategory<It, std::input_iterator_tag>::value>;
+
+    template <typename ExecutionPolicy>
+    using EnableIfExecutionPolicy = std::enable_if_t<std::is_execution_policy_v<std::decay_t<ExecutionPolicy>>>;
+
 public:
     using Iterator = Type *;
     using ConstIterator = const Type *;
+    using allocator_type = Allocator;
 
-    SimpleVector() noexcept = default;
+    SimpleVector() noexcept(noexcept(Allocator())) = default;
 
-    SimpleVector(ReserveProxyObj obj_) {
-        Reserve(obj_.capacity_);
+    explicit SimpleVector(const Allocator& allocator) noexcept
+            : data_(allocator) {
     }
 
-    explicit SimpleVector(size_t size)
-            : size_(size), capacity_(size), value_(size ? new Type[size] : nullptr) {
-        std::fill(begin(), begin() + size, Type());
+    SimpleVector(ReserveProxyObj obj_, const Allocator& allocator = Allocator())
+            : data_(obj_.capacity_, allocator) {
     }
 
-    SimpleVector(size_t size, const Type &value)
-            : size_(size), capacity_(size), value_(size ? new Type[size] : nullptr) {
-        std::fill(begin(), end(), value);
+    explicit SimpleVector(size_t size, const Allocator& allocator = Allocator())
+            : data_(size, allocator) {
+        ValueConstructN(data_.GetAddress(), size);
+        size_ = size;
     }
 
-    SimpleVector(std::initializer_list<Type> init)
-            : size_(init.size()), capacity_(init.size()), value_(init.size() ? new Type[init.size()] : nullptr) {
-        std::move(init.begin(), init.end(), value_.Get());
+    SimpleVector(size_t size, const Type &value, const Allocator& allocator = Allocator())
+            : data_(size, allocator) {
+        FillConstructN(data_.GetAddress(), size, value);
+        size_ = size;
+    }
+
+    //Перегрузки с политикой выполнения (std::execution::par и др.) обрабатывают элементы параллельно.
+    //Алгоритмы с политикой при исключении вызывают std::terminate, поэтому политика применяется,
+    //только если операция над элементом не выбрасывает исключений и распределитель - std::allocator;
+    //иначе работа идёт последовательно, как у перегрузки без политики
+    template <typename ExecutionPolicy, typename = EnableIfExecutionPolicy<ExecutionPolicy>>
+    SimpleVector(const ExecutionPolicy& policy, size_t size, const Type &value, const Allocator& allocator = Allocator())
+            : data_(size, allocator) {
+        FillConstructN(policy, data_.GetAddress(), size, value);
+        size_ = size;
+    }
+
+    template <typename ExecutionPolicy, typename = EnableIfExecutionPolicy<ExecutionPolicy>>
+    SimpleVector(const ExecutionPolicy& policy, const SimpleVector &other)
+            : data_(other.size_, AllocTraits::select_on_container_copy_construction(other.data_.GetAllocator())) {
+        CopyConstructN(policy, other.begin(), other.size_, data_.GetAddress());
+        size_ = other.size_;
+    }
+
+    SimpleVector(std::initializer_list<Type> init, const Allocator& allocator = Allocator())
+            : data_(init.size(), allocator) {
+        CopyConstructN(init.begin(), init.size(), data_.GetAddress());
+        size_ = init.size();
+    }
+
+    //память под прямой диапазон выделяется один раз; однопроходный диапазон добавляется по элементу
+    template <typename InputIterator, typename = EnableIfInputIterator<InputIterator>>
+    SimpleVector(InputIterator first, InputIterator last, const Allocator& allocator = Allocator())
+            : data_(allocator) {
+        if constexpr (IS_FORWARD_ITERATOR<InputIterator>) {
+            const auto count = static_cast<size_t>(std::distance(first, last));
+            RawMemory<Type, Allocator> new_data(count, allocator);
+            CopyConstructN(first, count, new_data.GetAddress());
+            data_.Swap(new_data);
+            size_ = count;
+        } else {
+            //деструктор недостроенного вектора не вызовется, поэтому элементы разрушаются здесь
+            try {
+                for (; first != last; ++first) {
+                    EmplaceBack(*first);
+                }
+            } catch (...) {
+                Clear();
+                throw;
+            }
+        }
+    }
+
+    SimpleVector(const SimpleVector &other)
+            : SimpleVector(other, AllocTraits::select_on_container_copy_construction(other.data_.GetAllocator())) {
+    }
+
+    SimpleVector(const SimpleVector &other, const Allocator& allocator)
+            : data_(other.size_, allocator) {
+        CopyConstructN(other.begin(), other.size_, data_.GetAddress());
+        size_ = other.size_;
+    }
+
+    SimpleVector(SimpleVector&& other) noexcept
+            : data_(std::move(other.data_)), size_(std::exchange(other.size_, 0)) {
+    }
+
+    ~SimpleVector() {
+        DestroyN(data_.GetAddress(), size_);
+    }
+
+    SimpleVector &operator=(const SimpleVector &rhs) {
+        if (this == &rhs) {
+            return *this;
+        }
+        if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+            //память, выделенная прежним распределителем, им же и освобождается
+            if (data_.GetAllocator() != rhs.data_.GetAllocator()) {
+                Clear();
+                data_.ResetAllocator(rhs.data_.GetAllocator());
+            }
+        }
+        AssignN(rhs.begin(), rhs.size_);
+        return *this;
+    }
+
+    //буфер забирается целиком, если распределитель переносится или равен распределителю other,
+    //иначе элементы перемещаются по одному в память этого вектора
+    SimpleVector& operator=(SimpleVector&& other) noexcept(AllocTraits::propagate_on_container_move_assignment::value
+                                                          || AllocTraits::is_always_equal::value) {
+        if (this == &other) {
+            return *this;
+        }
+        if constexpr (AllocTraits::propagate_on_container_move_assignment::value || AllocTraits::is_always_equal::value) {
+            StealBuffer(other);
+        } else {
+            if (data_.GetAllocator() == other.data_.GetAllocator()) {
+                StealBuffer(other);
+            } else {
+                AssignN(std::make_move_iterator(other.begin()), other.size_);
+                other.Clear();
+            }
+        }
+        return *this;
     }
 
     size_t GetSize() const noexcept {
@@ -42,28 +182,32 @@ public:
     }
 
     size_t GetCapacity() const noexcept {
-        return capacity_;
+        return data_.GetCapacity();
     }
 
     bool IsEmpty() const noexcept {
-        if (size_ == 0) {
-            return true;
-        } else return false;
+        return size_ == 0;
+    }
+
+    Allocator GetAllocator() const {
+        return data_.GetAllocator();
     }
 
     Type &operator[](size_t index) noexcept {
-        return value_[index];
+        assert(index < size_);
+        return data_[index];
     }
 
     const Type &operator[](size_t index) const noexcept {
-        return value_[index];
+        assert(index < size_);
+        return data_[index];
     }
 
     Type &At(size_t index) {
         if (index >= size_) {
             throw std::out_of_range("index>=size");
         } else {
-            return value_[index];
+            return data_[index];
         }
     }
 
@@ -71,177 +215,471 @@ public:
         if (index >= size_) {
             throw std::out_of_range("index>=size");
         } else {
-            return value_[index];
+            return data_[index];
         }
     }
 
     void Clear() noexcept {
+        DestroyN(data_.GetAddress(), size_);
         size_ = 0;
     }
 
     void Resize(size_t new_size) {
-        if (new_size > capacity_) {
-            size_t new_capacity_ = std::max(new_size, capacity_ * 2);
-            ArrayPtr<Type> new_values_(new_capacity_);
-
-            std::fill(new_values_.Get(), new_values_.Get() + new_capacity_, Type());
-            std::copy(std::make_move_iterator(begin()), std::make_move_iterator(end()), new_values_.Get());
-
-            new_values_.swap(value_);
-            size_ = new_size;
-            capacity_ = new_capacity_;
+        Resize(std::execution::seq, new_size);
+    }
 
+    template <typename ExecutionPolicy, typename = EnableIfExecutionPolicy<ExecutionPolicy>>
+    void Resize(const ExecutionPolicy& policy, size_t new_size) {
+        if (new_size < size_) {
+            DestroyN(begin() + new_size, size_ - new_size);
         } else if (new_size > size_) {
-            for (size_t i = size_; i < new_size; i++) {
-                value_[i] = Type();
+            if (new_size > data_.GetCapacity()) {
+                Reserve(policy, std::max(new_size, data_.GetCapacity() * 2));
             }
-        } else {
-            size_ = new_size;
+            ValueConstructN(policy, end(), new_size - size_);
         }
+        size_ = new_size;
+    }
 
+    //присваивает всем элементам value
+    void Fill(const Type& value) {
+        std::fill(begin(), end(), value);
+    }
+
+    template <typename ExecutionPolicy, typename = EnableIfExecutionPolicy<ExecutionPolicy>>
+    void Fill(const ExecutionPolicy& policy, const Type& value) {
+        if constexpr (std::is_nothrow_copy_assignable_v<Type>) {
+            std::fill(policy, begin(), end(), value);
+        } else {
+            Fill(value);
+        }
     }
 
     Iterator begin() noexcept {
-        return value_.Get();
+        return data_.GetAddress();
     }
 
     Iterator end() noexcept {
-        return value_.Get() + size_;
+        return data_.GetAddress() + size_;
     }
 
     ConstIterator begin() const noexcept {
-        return value_.Get();
+        return data_.GetAddress();
     }
 
     ConstIterator end() const noexcept {
-        return value_.Get() + size_;
+        return data_.GetAddress() + size_;
     }
 
     ConstIterator cbegin() const noexcept {
-        return value_.Get();
+        return data_.GetAddress();
     }
 
     ConstIterator cend() const noexcept {
-        return value_.Get() + size_;
+        return data_.GetAddress() + size_;
     }
 
-    SimpleVector(const SimpleVector &other)
-            : size_(other.GetSize()), capacity_(other.GetCapacity()), value_(other.GetSize()) {
-        std::copy(other.begin(), other.end(), begin());
+    void PushBack(const Type &item) {
+        EmplaceBack(item);
     }
 
-    SimpleVector(SimpleVector&& other) {
-        swap(other);
+    void PushBack(Type&& value) {
+        EmplaceBack(std::move(value));
     }
 
-    SimpleVector &operator=(const SimpleVector &rhs) {
-        if (rhs != *this) {
-            SimpleVector copy(rhs);
-            swap(copy);
+    //создаёт элемент в конце вектора из аргументов конструктора Type
+    template <typename... Args>
+    Type& EmplaceBack(Args&&... args) {
+        if (size_ == data_.GetCapacity()) {
+            EmplaceWithReallocation(size_, std::forward<Args>(args)...);
+        } else {
+            ConstructAt(end(), std::forward<Args>(args)...);
+            ++size_;
         }
-        return *this;
+        return data_[size_ - 1];
     }
 
-    SimpleVector& operator=(SimpleVector&& other) {
-        size_ = std::exchange(other.size_, 0);
-        capacity_ = std::exchange(other.capacity_, 0);
-        (std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()), value_.Get());
-        return *this;
+    Iterator Insert(ConstIterator pos, const Type& value) {
+        return Emplace(pos, value);
     }
 
-    void PushBack(const Type &item) {
-        Insert(end(), item);
+    Iterator Insert(ConstIterator pos, Type&& value) {
+        return Emplace(pos, std::move(value));
     }
 
-    void PushBack(Type&& value) {
-        Insert(end(), std::move(value));
+    //вставляет [first, last) перед pos: буфер растёт не больше одного раза, хвост сдвигается один раз.
+    //first и last не должны указывать в сам вектор. Возвращает итератор на первый вставленный элемент
+    template <typename InputIterator, typename = EnableIfInputIterator<InputIterator>>
+    Iterator Insert(ConstIterator pos, InputIterator first, InputIterator last) {
+        assert(pos >= cbegin() && pos <= cend());
+        const size_t index = pos - cbegin();
+        if constexpr (IS_FORWARD_ITERATOR<InputIterator>) {
+            InsertN(index, first, static_cast<size_t>(std::distance(first, last)));
+        } else {
+            //длину однопроходного диапазона заранее не узнать, поэтому он сначала собирается отдельно
+            SimpleVector items(first, last, data_.GetAllocator());
+            InsertN(index, std::make_move_iterator(items.begin()), items.size_);
+        }
+        return begin() + index;
     }
 
-    Iterator Insert(ConstIterator pos, const Type& value) {
-        return InsertInVector(pos, value);
+    Iterator Insert(ConstIterator pos, std::initializer_list<Type> items) {
+        return Insert(pos, items.begin(), items.end());
     }
 
-    Iterator Insert(ConstIterator pos, Type&& value) {
-        int dist = pos - begin();
-        if (size_ == capacity_) {
-            size_t new_capacity = std::max(1, (int)capacity_ * 2);
-            ArrayPtr<Type> tmp(new_capacity);
-            std::move(begin(), end(), tmp.Get());
-            value_.swap(tmp);
-            capacity_ = new_capacity;
-        }
-        std::move_backward(begin() + dist, end(), end() + 1);
-        *(begin() + dist) = std::move(value);
+    //создаёт элемент перед pos из аргументов конструктора Type.
+    //При исключении вектор остаётся прежним, если только не выбросил исключение
+    //перемещающий оператор присваивания при вставке в середину
+    template <typename... Args>
+    Iterator Emplace(ConstIterator pos, Args&&... args) {
+        assert(pos >= cbegin() && pos <= cend());
+        const size_t index = pos - cbegin();
+        if (size_ == data_.GetCapacity()) {
+            EmplaceWithReallocation(index, std::forward<Args>(args)...);
+            return begin() + index;
+        } else if (index == size_) {
+            ConstructAt(end(), std::forward<Args>(args)...);
+        } else if constexpr (RELOCATE_BYTES) {
+            //аргументы могут ссылаться на элемент самого вектора, поэтому значение создаётся до сдвига;
+            //хвост и новое значение переносятся побайтово, без перемещающих операций
+            alignas(Type) unsigned char value[sizeof(Type)];
+            ::new (static_cast<void*>(value)) Type(std::forward<Args>(args)...);
+            RelocateBytesOverlapping(begin() + index, size_ - index, begin() + index + 1);
+            RelocateBytes(reinterpret_cast<Type*>(value), 1, begin() + index);
+        } else {
+            Type value(std::forward<Args>(args)...);
+            ConstructAt(end(), std::move(data_[size_ - 1]));
+            std::move_backward(begin() + index, end() - 1, end());
+            data_[index] = std::move(value);
+        }
         ++size_;
-        return begin() + dist;
+        return begin() + index;
     }
 
     void PopBack() noexcept {
         if (!IsEmpty()) {
+            DestroyN(end() - 1, 1);
             --size_;
         }
     }
 
     Iterator Erase(ConstIterator pos) {
-        int dist = pos - begin();
-        std::move(begin() + dist + 1, end(), begin() + dist);
-        --size_;
-        return begin() + dist;
+        assert(pos >= cbegin() && pos < cend());
+        return Erase(pos, pos + 1);
     }
 
-    void Reserve(size_t new_capacity){
-        if (new_capacity > capacity_) {
-            ArrayPtr<Type> new_values_(new_capacity);
-            std::move(begin(), end(), new_values_.Get());
-            value_.swap(new_values_);
-            capacity_ = new_capacity;
+    //удаляет [first, last), сдвигая хвост один раз. Возвращает итератор на элемент, следовавший за удалёнными
+    Iterator Erase(ConstIterator first, ConstIterator last) {
+        assert(cbegin() <= first && first <= last && last <= cend());
+        const size_t index = first - cbegin();
+        const size_t count = last - first;
+        if (count != 0) {
+            if constexpr (RELOCATE_BYTES) {
+                DestroyN(begin() + index, count);
+                RelocateBytesOverlapping(begin() + index + count, size_ - index - count, begin() + index);
+            } else {
+                std::move(begin() + index + count, end(), begin() + index);
+                DestroyN(end() - count, count);
+            }
+            size_ -= count;
         }
+        return begin() + index;
     }
 
-    // Обменивает значение с другим вектором
+    void Reserve(size_t new_capacity) {
+        if (new_capacity <= data_.GetCapacity()) {
+            return;
+        }
+        RawMemory<Type, Allocator> new_data(new_capacity, data_.GetAllocator());
+        RelocateAround(new_data, size_, 0);
+    }
+
+    //параллельный перенос имеет смысл для больших массивов тривиально копируемых элементов,
+    //остальные переносятся как в Reserve без политики
+    template <typename ExecutionPolicy, typename = EnableIfExecutionPolicy<ExecutionPolicy>>
+    void Reserve(const ExecutionPolicy& policy, size_t new_capacity) {
+        if constexpr (IS_STD_ALLOCATOR && std::is_trivially_copyable_v<Type> && !IS_SEQUENCED_POLICY<ExecutionPolicy>) {
+            if (new_capacity <= data_.GetCapacity()) {
+                return;
+            }
+            RawMemory<Type, Allocator> new_data(new_capacity, data_.GetAllocator());
+            std::copy_n(policy, begin(), size_, new_data.GetAddress());
+            data_.Swap(new_data);
+        } else {
+            Reserve(new_capacity);
+        }
+    }
+
+    // Обменивает значение с другим вектором.
+    // Без propagate_on_container_swap распределители векторов должны быть равны
     void swap(SimpleVector &other) noexcept {
+        data_.Swap(other.data_);
         std::swap(size_, other.size_);
-        std::swap(capacity_, other.capacity_);
-        value_.swap(other.value_);
     }
 
 private:
+    //для std::allocator construct/destroy сводятся к размещающему new и деструктору,
+    //поэтому можно пользоваться стандартными алгоритмами с их оптимизациями для тривиальных типов
+    static constexpr bool IS_STD_ALLOCATOR = std::is_same_v<Allocator, std::allocator<Type>>;
+
+    //при std::allocator перенос элементов (рост буфера, сдвиг хвоста) сводится к memcpy/memmove.
+    //Для других распределителей construct/destroy могут быть наблюдаемы, и элементы переносятся через них
+    static constexpr bool RELOCATE_BYTES = IS_STD_ALLOCATOR && IsTriviallyRelocatable<Type>::value;
+
+    RawMemory<Type, Allocator> data_;
     std::size_t size_ = 0;
-    std::size_t capacity_ = 0;
-    ArrayPtr<Type> value_;
 
+    template <typename... Args>
+    void ConstructAt(Type* p, Args&&... args) {
+        AllocTraits::construct(data_.GetAllocator(), p, std::forward<Args>(args)...);
+    }
+
+    void DestroyN(Type* first, size_t count) noexcept {
+        if constexpr (IS_STD_ALLOCATOR) {
+            std::destroy_n(first, count);
+        } else {
+            for (size_t i = 0; i < count; ++i) {
+                AllocTraits::destroy(data_.GetAllocator(), first + i);
+            }
+        }
+    }
+
+    //создаёт count элементов с адреса first, i-й - вызовом construct(адрес, i);
+    //при исключении уже созданные элементы разрушаются
+    template <typename Constructor>
+    void ConstructN(Type* first, size_t count, Constructor construct) {
+        size_t i = 0;
+        try {
+            for (; i < count; ++i) {
+                construct(first + i, i);
+            }
+        } catch (...) {
+            DestroyN(first, i);
+            throw;
+        }
+    }
+
+    void ValueConstructN(Type* first, size_t count) {
+        if constexpr (IS_STD_ALLOCATOR) {
+            std::uninitialized_value_construct_n(first, count);
+        } else {
+            ConstructN(first, count, [this](Type* p, size_t) { ConstructAt(p); });
+        }
+    }
+
+    void FillConstructN(Type* first, size_t count, const Type& value) {
+        if constexpr (IS_STD_ALLOCATOR) {
+            std::uninitialized_fill_n(first, count, value);
+        } else {
+            ConstructN(first, count, [this, &value](Type* p, size_t) { ConstructAt(p, value); });
+        }
+    }
+
+    template <typename ExecutionPolicy>
+    void ValueConstructN(const ExecutionPolicy& policy, Type* first, size_t count) {
+        if constexpr (IS_STD_ALLOCATOR && std::is_nothrow_default_constructible_v<Type>) {
+            std::uninitialized_value_construct_n(policy, first, count);
+        } else {
+            ValueConstructN(first, count);
+        }
+    }
+
+    template <typename ExecutionPolicy>
+    void FillConstructN(const ExecutionPolicy& policy, Type* first, size_t count, const Type& value) {
+        if constexpr (IS_STD_ALLOCATOR && std::is_nothrow_copy_constructible_v<Type>) {
+            std::uninitialized_fill_n(policy, first, count, value);
+        } else {
+            FillConstructN(first, count, value);
+        }
+    }
+
+    template <typename ExecutionPolicy>
+    void CopyConstructN(const ExecutionPolicy& policy, const Type* from, size_t count, Type* to) {
+        if constexpr (IS_STD_ALLOCATOR && std::is_nothrow_copy_constructible_v<Type>) {
+            std::uninitialized_copy_n(policy, from, count, to);
+        } else {
+            CopyConstructN(from, count, to);
+        }
+    }
+
+    //from - итератор, по которому можно пройти count элементов
+    template <typename InputIterator>
+    void CopyConstructN(InputIterator from, size_t count, Type* to) {
+        if constexpr (IS_STD_ALLOCATOR) {
+            std::uninitialized_copy_n(from, count, to);
+        } else {
+            ConstructN(to, count, [this, &from](Type* p, size_t) {
+                ConstructAt(p, *from);
+                ++from;
+            });
+        }
+    }
+
+    //вставка в заполненный вектор: элемент создаётся в новом буфере до переноса старых элементов,
+    //поэтому аргументы могут ссылаться на элементы вектора
+    template <typename... Args>
+    void EmplaceWithReallocation(size_t index, Args&&... args) {
+        RawMemory<Type, Allocator> new_data(size_ == 0 ? 1 : size_ * 2, data_.GetAllocator());
+        ConstructAt(new_data + index, std::forward<Args>(args)...);
+        RelocateAround(new_data, index, 1);
+        ++size_;
+    }
+
+    //вставляет count элементов из first перед позицией index
+    template <typename ForwardIterator>
+    void InsertN(size_t index, ForwardIterator first, size_t count) {
+        if (count == 0) {
+            return;
+        }
+        if (size_ + count > data_.GetCapacity()) {
+            RawMemory<Type, Allocator> new_data(std::max(size_ + count, data_.GetCapacity() * 2), data_.GetAllocator());
+            CopyConstructN(first, count, new_data + index);
+            RelocateAround(new_data, index, count);
+            size_ += count;
+            return;
+        }
+        Type* position = begin() + index;
+        const size_t tail_size = size_ - index;
+        if constexpr (RELOCATE_BYTES) {
+            RelocateBytesOverlapping(position, tail_size, position + count);
+            try {
+                CopyConstructN(first, count, position);
+            } catch (...) {
+                RelocateBytesOverlapping(position + count, tail_size, position);
+                throw;
+            }
+            size_ += count;
+        } else if (tail_size > count) {
+            //последние count элементов хвоста переезжают в сырую память, остальные сдвигаются внутри вектора
+            Type* old_end = end();
+            CopyConstructN(std::make_move_iterator(old_end - count), count, old_end);
+            size_ += count;
+            std::move_backward(position, old_end - count, old_end);
+            std::copy_n(first, count, position);
+        } else {
+            //часть диапазона сразу создаётся в сырой памяти за концом, за ней - весь хвост
+            ForwardIterator middle = std::next(first, tail_size);
+            CopyConstructN(middle, count - tail_size, end());
+            size_ += count - tail_size;
+            CopyConstructN(std::make_move_iterator(position), tail_size, end());
+            size_ += tail_size;
+            std::copy_n(first, tail_size, position);
+        }
+    }
+
+    //переносит элементы в new_data вокруг уже созданных там элементов [index, index + count):
+    //[0, index) - в начало, [index, size) - сразу за ними - и делает new_data буфером вектора.
+    //При исключении созданные в new_data элементы разрушаются, а вектор остаётся прежним
+    void RelocateAround(RawMemory<Type, Allocator>& new_data, size_t index, size_t count) {
+        if constexpr (RELOCATE_BYTES) {
+            RelocateBytes(begin(), index, new_data.GetAddress());
+            RelocateBytes(begin() + index, size_ - index, new_data + index + count);
+        } else {
+            try {
+                UninitializedMoveOrCopy(begin(), index, new_data.GetAddress());
+            } catch (...) {
+                DestroyN(new_data + index, count);
+                throw;
+            }
+            try {
+                UninitializedMoveOrCopy(begin() + index, size_ - index, new_data + index + count);
+            } catch (...) {
+                DestroyN(new_data.GetAddress(), index + count);
+                throw;
+            }
+            DestroyN(begin(), size_);
+        }
+        data_.Swap(new_data);
+    }
+
+    //перемещает элементы в новый буфер; если перемещение может выбросить исключение,
+    //а копирование возможно, элементы копируются, чтобы при ошибке исходный буфер остался целым
+    void UninitializedMoveOrCopy(Type* from, size_t count, Type* to) {
+        if constexpr (std::is_nothrow_move_constructible_v<Type> || !std::is_copy_constructible_v<Type>) {
+            CopyConstructN(std::make_move_iterator(from), count, to);
+        } else {
+            CopyConstructN(from, count, to);
+        }
+    }
+
+    //заменяет содержимое count элементами из first, по возможности переиспользуя память и элементы
+    template <typename InputIterator>
+    void AssignN(InputIterator first, size_t count) {
+        if (count > data_.GetCapacity()) {
+            RawMemory<Type, Allocator> new_data(count, data_.GetAllocator());
+            CopyConstructN(first, count, new_data.GetAddress());
+            DestroyN(begin(), size_);
+            data_.Swap(new_data);
+        } else {
+            const size_t common_size = std::min(size_, count);
+            std::copy_n(first, common_size, begin());
+            if (count < size_) {
+                DestroyN(begin() + count, size_ - count);
+            } else {
+                CopyConstructN(std::next(first, common_size), count - size_, end());
+            }
+        }
+        size_ = count;
+    }
+
+    void StealBuffer(SimpleVector& other) noexcept {
+        Clear();
+        data_ = std::move(other.data_);
+        size_ = std::exchange(other.size_, 0);
+    }
 };
 
-template<typename Type>
-inline bool operator==(const SimpleVector<Type> &lhs, const SimpleVector<Type> &rhs) {
-    return (lhs.GetSize() == rhs.GetSize() && std::equal(lhs.begin(), lhs.end(), rhs.begin()));
+template<typename Type, typename Allocator>
+inline bool operator==(const SimpleVector<Type, Allocator> &lhs, const SimpleVector<Type, Allocator> &rhs) {
+    return (lhs.GetSize() == rhs.GetSize() && EqualElements(lhs.begin(), rhs.begin(), lhs.GetSize()));
 }
 
-template<typename Type>
-inline bool operator!=(const SimpleVector<Type> &lhs, const SimpleVector<Type> &rhs) {
+template<typename Type, typename Allocator>
+inline bool operator!=(const SimpleVector<Type, Allocator> &lhs, const SimpleVector<Type, Allocator> &rhs) {
     return !(lhs == rhs);
 }
 
-template<typename Type>
-inline bool operator<(const SimpleVector<Type> &lhs, const SimpleVector<Type> &rhs) {
-    return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+template<typename Type, typename Allocator>
+inline bool operator<(const SimpleVector<Type, Allocator> &lhs, const SimpleVector<Type, Allocator> &rhs) {
+    return LessElements(lhs.begin(), lhs.GetSize(), rhs.begin(), rhs.GetSize());
 }
 
-template<typename Type>
-inline bool operator<=(const SimpleVector<Type> &lhs, const SimpleVector<Type> &rhs) {
+template<typename Type, typename Allocator>
+inline bool operator<=(const SimpleVector<Type, Allocator> &lhs, const SimpleVector<Type, Allocator> &rhs) {
     return !(lhs > rhs);
 }
 
-template<typename Type>
-inline bool operator>(const SimpleVector<Type> &lhs, const SimpleVector<Type> &rhs) {
-    return std::lexicographical_compare(rhs.begin(), rhs.end(), lhs.begin(), lhs.end());
+template<typename Type, typename Allocator>
+inline bool operator>(const SimpleVector<Type, Allocator> &lhs, const SimpleVector<Type, Allocator> &rhs) {
+    return rhs < lhs;
 }
 
-template<typename Type>
-inline bool operator>=(const SimpleVector<Type> &lhs, const SimpleVector<Type> &rhs) {
+template<typename Type, typename Allocator>
+inline bool operator>=(const SimpleVector<Type, Allocator> &lhs, const SimpleVector<Type, Allocator> &rhs) {
     return !(lhs < rhs);
 }
 
-ReserveProxyObj Reserve(size_t capacity_to_reserve) {
+//сравнения с политикой выполнения. Исключение из сравнения элементов внутри параллельного алгоритма
+//вызывает std::terminate, поэтому политика используется только при noexcept-сравнении;
+//иначе, как и для seq, сравнение идёт последовательно операторами вектора
+template<typename ExecutionPolicy, typename Type, typename Allocator>
+bool Equal(const ExecutionPolicy& policy, const SimpleVector<Type, Allocator> &lhs, const SimpleVector<Type, Allocator> &rhs) {
+    if constexpr (IS_SEQUENCED_POLICY<ExecutionPolicy> || !IS_NOTHROW_EQUALITY_COMPARABLE<Type>) {
+        return lhs == rhs;
+    } else {
+        return (lhs.GetSize() == rhs.GetSize() && std::equal(policy, lhs.begin(), lhs.end(), rhs.begin()));
+    }
+}
+
+template<typename ExecutionPolicy, typename Type, typename Allocator>
+bool LexicographicalCompare(const ExecutionPolicy& policy, const SimpleVector<Type, Allocator> &lhs, const SimpleVector<Type, Allocator> &rhs) {
+    if constexpr (IS_SEQUENCED_POLICY<ExecutionPolicy> || !IS_NOTHROW_LESS_COMPARABLE<Type>) {
+        return lhs < rhs;
+    } else {
+        return std::lexicographical_compare(policy, lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+}
+
+inline ReserveProxyObj Reserve(size_t capacity_to_reserve) {
     return ReserveProxyObj(capacity_to_reserve);
 }
\ No newline at end of file
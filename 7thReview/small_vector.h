@@ -0,0 +1,520 @@
+#pragma once
+
+#include <cassert>
+#include "element_compare.h"
+#include "simple_vector.h"
+#include <algorithm>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+//Вектор с буфером на N элементов внутри объекта: пока элементов не больше N, память
+//в куче не выделяется, при переполнении элементы переносятся в буфер в куче.
+//Интерфейс совпадает с SimpleVector. Перемещение вектора из кучи забирает буфер,
+//вектор со встроенным буфером перемещается поэлементно
+template<typename Type, size_t N>
+class SmallVector {
+    template <typename It>
+    static constexpr bool IS_FORWARD_ITERATOR = IsIteratorOfCategory<It, std::forward_iterator_tag>::value;
+
+    template <typename It>
+    using EnableIfInputIterator = std::enable_if_t<IsIteratorOfCategory<It, std::input_iterator_tag>::value>;
+
+public:
+    static_assert(N > 0, "SmallVector needs at least one inline element");
+
+    using Iterator = Type *;
+    using ConstIterator = const Type *;
+
+    SmallVector() noexcept = default;
+
+    SmallVector(ReserveProxyObj obj_) {
+        Reserve(obj_.capacity_);
+    }
+
+    explicit SmallVector(size_t size) {
+        ConstructN(size, [size](Type* data) {
+            std::uninitialized_value_construct_n(data, size);
+        });
+    }
+
+    SmallVector(size_t size, const Type &value) {
+        ConstructN(size, [size, &value](Type* data) {
+            std::uninitialized_fill_n(data, size, value);
+        });
+    }
+
+    SmallVector(std::initializer_list<Type> init) {
+        ConstructN(init.size(), [&init](Type* data) {
+            std::uninitialized_copy(init.begin(), init.end(), data);
+        });
+    }
+
+    SmallVector(const SmallVector &other) {
+        ConstructN(other.size_, [&other](Type* data) {
+            std::uninitialized_copy_n(other.data_, other.size_, data);
+        });
+    }
+
+    SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<Type>) {
+        if (other.IsInline()) {
+            std::uninitialized_move_n(other.data_, other.size_, data_);
+            size_ = other.size_;
+            other.Clear();
+        } else {
+            StealHeapBuffer(other);
+        }
+    }
+
+    ~SmallVector() {
+        std::destroy_n(data_, size_);
+        FreeHeapBuffer();
+    }
+
+    SmallVector &operator=(const SmallVector &rhs) {
+        if (this != &rhs) {
+            AssignN(rhs.data_, rhs.size_);
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<Type>
+                                                        && std::is_nothrow_move_assignable_v<Type>) {
+        if (this == &other) {
+            return *this;
+        }
+        if (other.IsInline()) {
+            AssignN(std::make_move_iterator(other.data_), other.size_);
+            other.Clear();
+        } else {
+            Clear();
+            FreeHeapBuffer();
+            StealHeapBuffer(other);
+        }
+        return *this;
+    }
+
+    size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    size_t GetCapacity() const noexcept {
+        return capacity_;
+    }
+
+    bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    //элементы находятся во встроенном буфере
+    bool IsInline() const noexcept {
+        return data_ == InlineData();
+    }
+
+    Type &operator[](size_t index) noexcept {
+        assert(index < size_);
+        return data_[index];
+    }
+
+    const Type &operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return data_[index];
+    }
+
+    Type &At(size_t index) {
+        if (index >= size_) {
+            throw std::out_of_range("index>=size");
+        }
+        return data_[index];
+    }
+
+    const Type &At(size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("index>=size");
+        }
+        return data_[index];
+    }
+
+    void Clear() noexcept {
+        std::destroy_n(data_, size_);
+        size_ = 0;
+    }
+
+    void Resize(size_t new_size) {
+        if (new_size < size_) {
+            std::destroy_n(data_ + new_size, size_ - new_size);
+        } else if (new_size > size_) {
+            if (new_size > capacity_) {
+                Reserve(std::max(new_size, capacity_ * 2));
+            }
+            std::uninitialized_value_construct_n(end(), new_size - size_);
+        }
+        size_ = new_size;
+    }
+
+    Iterator begin() noexcept {
+        return data_;
+    }
+
+    Iterator end() noexcept {
+        return data_ + size_;
+    }
+
+    ConstIterator begin() const noexcept {
+        return data_;
+    }
+
+    ConstIterator end() const noexcept {
+        return data_ + size_;
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return data_;
+    }
+
+    ConstIterator cend() const noexcept {
+        return data_ + size_;
+    }
+
+    void PushBack(const Type &item) {
+        EmplaceBack(item);
+    }
+
+    void PushBack(Type&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    template <typename... Args>
+    Type& EmplaceBack(Args&&... args) {
+        if (size_ == capacity_) {
+            EmplaceWithReallocation(size_, std::forward<Args>(args)...);
+        } else {
+            new (end()) Type(std::forward<Args>(args)...);
+            ++size_;
+        }
+        return data_[size_ - 1];
+    }
+
+    Iterator Insert(ConstIterator pos, const Type& value) {
+        return Emplace(pos, value);
+    }
+
+    Iterator Insert(ConstIterator pos, Type&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+    //вставляет [first, last) перед pos: буфер растёт не больше одного раза, хвост сдвигается один раз.
+    //first и last не должны указывать в сам вектор. Возвращает итератор на первый вставленный элемент
+    template <typename InputIterator, typename = EnableIfInputIterator<InputIterator>>
+    Iterator Insert(ConstIterator pos, InputIterator first, InputIterator last) {
+        assert(pos >= cbegin() && pos <= cend());
+        const size_t index = pos - cbegin();
+        if constexpr (IS_FORWARD_ITERATOR<InputIterator>) {
+            InsertN(index, first, static_cast<size_t>(std::distance(first, last)));
+        } else {
+            //длину однопроходного диапазона заранее не узнать, поэтому он сначала собирается отдельно
+            SimpleVector<Type> items(first, last);
+            InsertN(index, std::make_move_iterator(items.begin()), items.GetSize());
+        }
+        return begin() + index;
+    }
+
+    Iterator Insert(ConstIterator pos, std::initializer_list<Type> items) {
+        return Insert(pos, items.begin(), items.end());
+    }
+
+    template <typename... Args>
+    Iterator Emplace(ConstIterator pos, Args&&... args) {
+        assert(pos >= cbegin() && pos <= cend());
+        const size_t index = pos - cbegin();
+        if (size_ == capacity_) {
+            EmplaceWithReallocation(index, std::forward<Args>(args)...);
+            return begin() + index;
+        } else if (index == size_) {
+            new (end()) Type(std::forward<Args>(args)...);
+        } else {
+            //аргументы могут ссылаться на элемент самого вектора, поэтому значение создаётся до сдвига
+            Type value(std::forward<Args>(args)...);
+            new (end()) Type(std::move(data_[size_ - 1]));
+            std::move_backward(begin() + index, end() - 1, end());
+            data_[index] = std::move(value);
+        }
+        ++size_;
+        return begin() + index;
+    }
+
+    void PopBack() noexcept {
+        if (!IsEmpty()) {
+            std::destroy_at(end() - 1);
+            --size_;
+        }
+    }
+
+    Iterator Erase(ConstIterator pos) {
+        assert(pos >= cbegin() && pos < cend());
+        return Erase(pos, pos + 1);
+    }
+
+    //удаляет [first, last), сдвигая хвост один раз. Возвращает итератор на элемент, следовавший за удалёнными
+    Iterator Erase(ConstIterator first, ConstIterator last) {
+        assert(cbegin() <= first && first <= last && last <= cend());
+        const size_t index = first - cbegin();
+        const size_t count = last - first;
+        if (count != 0) {
+            if constexpr (RELOCATE_BYTES) {
+                std::destroy_n(begin() + index, count);
+                RelocateBytesOverlapping(begin() + index + count, size_ - index - count, begin() + index);
+            } else {
+                std::move(begin() + index + count, end(), begin() + index);
+                std::destroy_n(end() - count, count);
+            }
+            size_ -= count;
+        }
+        return begin() + index;
+    }
+
+    void Reserve(size_t new_capacity) {
+        if (new_capacity <= capacity_) {
+            return;
+        }
+        Type* new_data = AllocateHeapBuffer(new_capacity);
+        try {
+            UninitializedMoveOrCopy(data_, size_, new_data);
+        } catch (...) {
+            DeallocateHeapBuffer(new_data, new_capacity);
+            throw;
+        }
+        ReplaceBuffer(new_data, new_capacity);
+    }
+
+    // Обменивает значение с другим вектором
+    void swap(SmallVector &other) noexcept(std::is_nothrow_move_constructible_v<Type>
+                                           && std::is_nothrow_move_assignable_v<Type>) {
+        if (!IsInline() && !other.IsInline()) {
+            std::swap(data_, other.data_);
+            std::swap(size_, other.size_);
+            std::swap(capacity_, other.capacity_);
+            return;
+        }
+        SmallVector tmp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+private:
+    //элементы сдвигаются внутри буфера побайтово, без перемещающих операций
+    static constexpr bool RELOCATE_BYTES = IsTriviallyRelocatable<Type>::value;
+
+    alignas(Type) unsigned char inline_buffer_[sizeof(Type) * N];
+    Type* data_ = InlineData();
+    size_t size_ = 0;
+    size_t capacity_ = N;
+
+    Type* InlineData() noexcept {
+        return reinterpret_cast<Type*>(inline_buffer_);
+    }
+
+    const Type* InlineData() const noexcept {
+        return reinterpret_cast<const Type*>(inline_buffer_);
+    }
+
+    static Type* AllocateHeapBuffer(size_t capacity) {
+        return std::allocator<Type>().allocate(capacity);
+    }
+
+    static void DeallocateHeapBuffer(Type* buffer, size_t capacity) noexcept {
+        std::allocator<Type>().deallocate(buffer, capacity);
+    }
+
+    void FreeHeapBuffer() noexcept {
+        if (!IsInline()) {
+            DeallocateHeapBuffer(data_, capacity_);
+            data_ = InlineData();
+            capacity_ = N;
+        }
+    }
+
+    //создаёт count элементов в только что созданном векторе. Деструктор недостроенного объекта
+    //не вызывается, поэтому при исключении из конструктора элемента буфер в куче освобождается здесь
+    //(созданные к этому моменту элементы разрушают сами алгоритмы uninitialized_*)
+    template <typename Initializer>
+    void ConstructN(size_t count, Initializer initialize) {
+        Reserve(count);
+        try {
+            initialize(data_);
+        } catch (...) {
+            FreeHeapBuffer();
+            throw;
+        }
+        size_ = count;
+    }
+
+    //разрушает элементы текущего буфера и переходит на new_data, куда они уже перенесены
+    void ReplaceBuffer(Type* new_data, size_t new_capacity) noexcept {
+        std::destroy_n(data_, size_);
+        FreeHeapBuffer();
+        data_ = new_data;
+        capacity_ = new_capacity;
+    }
+
+    //забирает буфер в куче у other; этот вектор должен быть пуст и без буфера в куче
+    void StealHeapBuffer(SmallVector& other) noexcept {
+        data_ = std::exchange(other.data_, other.InlineData());
+        size_ = std::exchange(other.size_, 0);
+        capacity_ = std::exchange(other.capacity_, N);
+    }
+
+    //вставка в заполненный вектор: элемент создаётся в новом буфере до переноса старых элементов,
+    //поэтому аргументы могут ссылаться на элементы вектора
+    template <typename... Args>
+    void EmplaceWithReallocation(size_t index, Args&&... args) {
+        const size_t new_capacity = capacity_ * 2;
+        Type* new_data = AllocateHeapBuffer(new_capacity);
+        try {
+            new (new_data + index) Type(std::forward<Args>(args)...);
+        } catch (...) {
+            DeallocateHeapBuffer(new_data, new_capacity);
+            throw;
+        }
+        RelocateAround(new_data, new_capacity, index, 1);
+        ++size_;
+    }
+
+    //вставляет count элементов из first перед позицией index
+    template <typename ForwardIterator>
+    void InsertN(size_t index, ForwardIterator first, size_t count) {
+        if (count == 0) {
+            return;
+        }
+        if (size_ + count > capacity_) {
+            const size_t new_capacity = std::max(size_ + count, capacity_ * 2);
+            Type* new_data = AllocateHeapBuffer(new_capacity);
+            try {
+                std::uninitialized_copy_n(first, count, new_data + index);
+            } catch (...) {
+                DeallocateHeapBuffer(new_data, new_capacity);
+                throw;
+            }
+            RelocateAround(new_data, new_capacity, index, count);
+            size_ += count;
+            return;
+        }
+        Type* position = begin() + index;
+        const size_t tail_size = size_ - index;
+        if constexpr (RELOCATE_BYTES) {
+            RelocateBytesOverlapping(position, tail_size, position + count);
+            try {
+                std::uninitialized_copy_n(first, count, position);
+            } catch (...) {
+                RelocateBytesOverlapping(position + count, tail_size, position);
+                throw;
+            }
+            size_ += count;
+        } else if (tail_size > count) {
+            //последние count элементов хвоста переезжают в сырую память, остальные сдвигаются внутри вектора
+            Type* old_end = end();
+            std::uninitialized_move_n(old_end - count, count, old_end);
+            size_ += count;
+            std::move_backward(position, old_end - count, old_end);
+            std::copy_n(first, count, position);
+        } else {
+            //часть диапазона сразу создаётся в сырой памяти за концом, за ней - весь хвост
+            ForwardIterator middle = std::next(first, tail_size);
+            std::uninitialized_copy_n(middle, count - tail_size, end());
+            size_ += count - tail_size;
+            std::uninitialized_move_n(position, tail_size, end());
+            size_ += tail_size;
+            std::copy_n(first, tail_size, position);
+        }
+    }
+
+    //переносит элементы в new_data вокруг уже созданных там элементов [index, index + count):
+    //[0, index) - в начало, [index, size) - сразу за ними - и делает new_data буфером вектора.
+    //При исключении созданные в new_data элементы разрушаются, new_data освобождается, а вектор остаётся прежним
+    void RelocateAround(Type* new_data, size_t new_capacity, size_t index, size_t count) {
+        try {
+            try {
+                UninitializedMoveOrCopy(data_, index, new_data);
+            } catch (...) {
+                std::destroy_n(new_data + index, count);
+                throw;
+            }
+            try {
+                UninitializedMoveOrCopy(data_ + index, size_ - index, new_data + index + count);
+            } catch (...) {
+                std::destroy_n(new_data, index + count);
+                throw;
+            }
+        } catch (...) {
+            DeallocateHeapBuffer(new_data, new_capacity);
+            throw;
+        }
+        ReplaceBuffer(new_data, new_capacity);
+    }
+
+    static void UninitializedMoveOrCopy(Type* from, size_t count, Type* to) {
+        if constexpr (std::is_nothrow_move_constructible_v<Type> || !std::is_copy_constructible_v<Type>) {
+            std::uninitialized_move_n(from, count, to);
+        } else {
+            std::uninitialized_copy_n(from, count, to);
+        }
+    }
+
+    //заменяет содержимое count элементами из first, по возможности переиспользуя память и элементы
+    template <typename InputIterator>
+    void AssignN(InputIterator first, size_t count) {
+        if (count > capacity_) {
+            Type* new_data = AllocateHeapBuffer(count);
+            try {
+                std::uninitialized_copy_n(first, count, new_data);
+            } catch (...) {
+                DeallocateHeapBuffer(new_data, count);
+                throw;
+            }
+            ReplaceBuffer(new_data, count);
+        } else {
+            const size_t common_size = std::min(size_, count);
+            std::copy_n(first, common_size, begin());
+            if (count < size_) {
+                std::destroy_n(data_ + count, size_ - count);
+            } else {
+                std::uninitialized_copy_n(first + common_size, count - size_, end());
+            }
+        }
+        size_ = count;
+    }
+};
+
+template<typename Type, size_t N>
+inline bool operator==(const SmallVector<Type, N> &lhs, const SmallVector<Type, N> &rhs) {
+    return (lhs.GetSize() == rhs.GetSize() && EqualElements(lhs.begin(), rhs.begin(), lhs.GetSize()));
+}
+
+template<typename Type, size_t N>
+inline bool operator!=(const SmallVector<Type, N> &lhs, const SmallVector<Type, N> &rhs) {
+    return !(lhs == rhs);
+}
+
+template<typename Type, size_t N>
+inline bool operator<(const SmallVector<Type, N> &lhs, const SmallVector<Type, N> &rhs) {
+    return LessElements(lhs.begin(), lhs.GetSize(), rhs.begin(), rhs.GetSize());
+}
+
+template<typename Type, size_t N>
+inline bool operator<=(const SmallVector<Type, N> &lhs, const SmallVector<Type, N> &rhs) {
+    return !(lhs > rhs);
+}
+
+template<typename Type, size_t N>
+inline bool operator>(const SmallVector<Type, N> &lhs, const SmallVector<Type, N> &rhs) {
+    return rhs < lhs;
+}
+
+template<typename Type, size_t N>
+inline bool operator>=(const SmallVector<Type, N> &lhs, const SmallVector<Type, N> &rhs) {
+    return !(lhs < rhs);
+}
\ No newline at end of file